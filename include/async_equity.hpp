@@ -0,0 +1,188 @@
+#ifndef __POKER_ASYNC_EQUITY_HPP__
+#define __POKER_ASYNC_EQUITY_HPP__
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include "game.hpp"
+
+struct EquityEstimate
+{
+    double equity = 0.0;
+    double standardError = 0.0;
+    std::size_t trials = 0;
+    // Half-width of the normal confidence interval, 1.96 gives ~95%.
+    inline constexpr double errorBound(double z = 1.96) const noexcept { return z * standardError; }
+};
+
+// Handle to an equity simulation running on a thread pool. The estimate can be read at any
+// time while workers are still publishing chunks; cancelling stops them after the chunk
+// they are currently running. Dropping the handle cancels the job. A moved-from handle is
+// not valid() and behaves like a finished job with no trials.
+class AsyncEquity
+{
+private:
+    struct SharedState
+    {
+        Deck playerCards;
+        Deck tableCards;
+        Deck deck;
+        std::size_t numPlayers;
+        std::uint64_t seed;
+        ChunkScheduler scheduler;
+        std::stop_source stop;
+        mutable std::mutex mutex;
+        std::condition_variable finishedCondition;
+        EquityResult counts;
+        std::size_t activeWorkers = 0;
+        inline SharedState(Deck player, Deck table, std::size_t total, std::size_t players, std::uint64_t seed_, std::size_t chunkSize)
+            : playerCards(player), tableCards(table), deck(Deck::createFullDeck()), numPlayers(players), seed(seed_), scheduler(total, chunkSize)
+        {
+            deck.removeCards(playerCards);
+            deck.removeCards(tableCards);
+        }
+    };
+    std::shared_ptr<SharedState> m_state;
+
+    static inline void work(const std::shared_ptr<SharedState> &state)
+    {
+        std::stop_token token = state->stop.get_token();
+        ChunkRange chunk;
+        while (!token.stop_requested() && state->scheduler.claim(chunk))
+        {
+            omp::XoroShiro128Plus rng(chunkSeed(state->seed, chunk.index));
+            EquityResult local;
+            for (std::size_t i = 0; i < chunk.size(); ++i)
+            {
+                local.add(playRandomGame(rng, state->playerCards, state->tableCards, state->deck, state->numPlayers));
+            }
+            std::lock_guard lock(state->mutex);
+            state->counts += local;
+        }
+        std::lock_guard lock(state->mutex);
+        if (--state->activeWorkers == 0)
+        {
+            state->finishedCondition.notify_all();
+        }
+    }
+
+public:
+    // Smaller chunks than the blocking call so cancellation and deadlines react quickly.
+    static constexpr std::size_t maxChunkSize = 1024;
+
+    inline AsyncEquity(const Deck playerCards, const Deck tableCards, std::size_t numSimulations, std::size_t numPlayers, BS::thread_pool<BS::tp::none> &threadPool, std::uint64_t seed)
+    {
+        if (!supportedTableSize(numPlayers))
+        {
+            return;
+        }
+        const std::size_t poolThreads = threadPool.get_thread_count();
+        const std::size_t chunkSize = std::min(ChunkScheduler::chunkSizeFor(numSimulations, poolThreads), maxChunkSize);
+        m_state = std::make_shared<SharedState>(playerCards, tableCards, numSimulations, numPlayers, seed, chunkSize);
+        const std::size_t workers = std::min(poolThreads, m_state->scheduler.numChunks());
+        m_state->activeWorkers = workers;
+        for (std::size_t i = 0; i < workers; ++i)
+        {
+            threadPool.detach_task([state = m_state]()
+                                   { work(state); });
+        }
+    }
+    AsyncEquity(const AsyncEquity &) = delete;
+    AsyncEquity &operator=(const AsyncEquity &) = delete;
+    AsyncEquity(AsyncEquity &&) noexcept = default;
+    AsyncEquity &operator=(AsyncEquity &&other) noexcept
+    {
+        cancel();
+        m_state = std::move(other.m_state);
+        return *this;
+    }
+    inline ~AsyncEquity() { cancel(); }
+
+    inline bool valid() const noexcept { return m_state != nullptr; }
+    inline EquityEstimate estimate() const
+    {
+        if (!m_state)
+        {
+            return {};
+        }
+        EquityResult counts;
+        {
+            std::lock_guard lock(m_state->mutex);
+            counts = m_state->counts;
+        }
+        EquityEstimate result;
+        result.trials = counts.trials();
+        result.equity = counts.equity();
+        // Per-trial shares take values other than 0 and 1 once pots are split, so the error
+        // comes from their sample variance rather than the Bernoulli formula.
+        result.standardError = counts.standardError();
+        return result;
+    }
+    inline void cancel() noexcept
+    {
+        if (m_state)
+        {
+            m_state->stop.request_stop();
+        }
+    }
+    inline bool done() const
+    {
+        if (!m_state)
+        {
+            return true;
+        }
+        std::lock_guard lock(m_state->mutex);
+        return m_state->activeWorkers == 0;
+    }
+    template <typename TClock, typename TDuration>
+    inline bool waitUntil(const std::chrono::time_point<TClock, TDuration> &deadline) const
+    {
+        if (!m_state)
+        {
+            return true;
+        }
+        std::unique_lock lock(m_state->mutex);
+        return m_state->finishedCondition.wait_until(lock, deadline, [this]
+                                                     { return m_state->activeWorkers == 0; });
+    }
+    template <typename TRep, typename TPeriod>
+    inline bool waitFor(const std::chrono::duration<TRep, TPeriod> &timeout) const
+    {
+        return waitUntil(std::chrono::steady_clock::now() + timeout);
+    }
+    inline EquityEstimate get() const
+    {
+        if (!m_state)
+        {
+            return {};
+        }
+        std::unique_lock lock(m_state->mutex);
+        m_state->finishedCondition.wait(lock, [this]
+                                        { return m_state->activeWorkers == 0; });
+        lock.unlock();
+        return estimate();
+    }
+    // Waits for completion or the deadline, whichever comes first, then stops the remaining
+    // work and returns whatever precision was reached.
+    template <typename TClock, typename TDuration>
+    inline EquityEstimate estimateBy(const std::chrono::time_point<TClock, TDuration> &deadline)
+    {
+        if (!waitUntil(deadline))
+        {
+            cancel();
+        }
+        return estimate();
+    }
+};
+
+// Pass numSimulations = std::numeric_limits<std::size_t>::max() to keep refining until the
+// handle is cancelled or dropped. A table size outside [2, EquityResult::maxPlayers] gives a
+// handle that is not valid().
+inline AsyncEquity probabilityOfWinningAsync(const Deck playerCards, const Deck tableCards, std::size_t numSimulations, std::size_t numPlayers, BS::thread_pool<BS::tp::none> &threadPool, std::uint64_t seed = randomSeed())
+{
+    return AsyncEquity(playerCards, tableCards, numSimulations, numPlayers, threadPool, seed);
+}
+#endif // __POKER_ASYNC_EQUITY_HPP__
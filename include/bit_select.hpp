@@ -0,0 +1,208 @@
+#ifndef __POKER_BIT_SELECT_HPP__
+#define __POKER_BIT_SELECT_HPP__
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__GNUC__)
+#include <cpuid.h>
+#endif
+
+// How Deck maps "the i-th remaining card" to a mask bit. PDEP does it in one instruction on
+// Intel since Haswell and AMD since Zen 3, but is microcoded on Zen 1 / Zen 2 (and Hygon),
+// where it takes hundreds of cycles depending on the mask; there the broadword select below
+// is several times faster.
+enum class SelectPath : std::uint8_t
+{
+    // Not resolved yet; the first deposit probes the CPU.
+    Auto = 0,
+    Pdep = 1,
+    Broadword = 2,
+};
+
+namespace detail
+{
+    // selectInByte[k][b]: position of the k-th set bit of byte b, 8 when b has fewer bits.
+    inline constexpr std::array<std::array<std::uint8_t, 256>, 8> selectInByte = []()
+    {
+        std::array<std::array<std::uint8_t, 256>, 8> table{};
+        for (std::size_t b = 0; b < 256; ++b)
+        {
+            std::size_t k = 0;
+            for (std::size_t pos = 0; pos < 8; ++pos)
+            {
+                if (b & (1u << pos))
+                {
+                    table[k++][b] = static_cast<std::uint8_t>(pos);
+                }
+            }
+            for (; k < 8; ++k)
+            {
+                table[k][b] = 8;
+            }
+        }
+        return table;
+    }();
+
+    inline constinit std::atomic<SelectPath> selectPathState{SelectPath::Auto};
+
+    inline bool cpuHasBmi2() noexcept
+    {
+#if defined(_MSC_VER)
+        int regs[4];
+        __cpuid(regs, 0);
+        if (regs[0] < 7)
+        {
+            return false;
+        }
+        __cpuidex(regs, 7, 0);
+        return (regs[1] & (1 << 8)) != 0;
+#elif defined(__GNUC__)
+        unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+        return __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx & (1u << 8)) != 0;
+#else
+        return false;
+#endif
+    }
+    // PDEP runs in hardware on every BMI2 part except AMD and Hygon before family 0x19 (Zen 3).
+    inline bool cpuHasFastPdep() noexcept
+    {
+        if (!cpuHasBmi2())
+        {
+            return false;
+        }
+        unsigned vendor[3] = {};
+        unsigned signature = 0;
+#if defined(_MSC_VER)
+        int regs[4];
+        __cpuid(regs, 0);
+        vendor[0] = static_cast<unsigned>(regs[1]);
+        vendor[1] = static_cast<unsigned>(regs[3]);
+        vendor[2] = static_cast<unsigned>(regs[2]);
+        __cpuid(regs, 1);
+        signature = static_cast<unsigned>(regs[0]);
+#elif defined(__GNUC__)
+        unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+        __get_cpuid(0, &eax, &ebx, &ecx, &edx);
+        vendor[0] = ebx;
+        vendor[1] = edx;
+        vendor[2] = ecx;
+        __get_cpuid(1, &signature, &ebx, &ecx, &edx);
+#endif
+        // "AuthenticAMD" and "HygonGenuine", as the first register of the vendor string.
+        const bool amdLike = vendor[0] == 0x68747541 || vendor[0] == 0x6F677948;
+        if (!amdLike)
+        {
+            return true;
+        }
+        unsigned family = (signature >> 8) & 0xF;
+        if (family == 0xF)
+        {
+            family += (signature >> 20) & 0xFF;
+        }
+        return family >= 0x19;
+    }
+
+#if defined(__GNUC__) && !defined(__BMI2__)
+    __attribute__((target("bmi2")))
+#endif
+    inline std::uint64_t pdepInstruction(std::uint64_t x, std::uint64_t mask) noexcept
+    {
+        return _pdep_u64(x, mask);
+    }
+
+    // Byte i of the result holds the number of set bits in bytes 0..i of x, at most 64, so
+    // the high bit of every byte stays clear.
+    inline constexpr std::uint64_t runningByteCounts(std::uint64_t x) noexcept
+    {
+        std::uint64_t counts = x - ((x >> 1) & 0x5555555555555555ull);
+        counts = (counts & 0x3333333333333333ull) + ((counts >> 2) & 0x3333333333333333ull);
+        counts = (counts + (counts >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+        return counts * 0x0101010101010101ull;
+    }
+    // selectBit for k below popcount(x), given runningByteCounts(x).
+    inline constexpr unsigned selectWithCounts(std::uint64_t x, std::uint64_t totals, unsigned k) noexcept
+    {
+        constexpr std::uint64_t highs = 0x8080808080808080ull;
+        // High bit of byte i set when k >= total i; the high bits in k * ones keep the
+        // subtraction from borrowing across bytes.
+        const std::uint64_t atMostK = (((k * 0x0101010101010101ull) | highs) - totals) & highs;
+        const unsigned byte = static_cast<unsigned>(std::popcount(atMostK)) * 8;
+        const unsigned before = static_cast<unsigned>(((totals << 8) >> byte) & 0xFF);
+        return byte + selectInByte[k - before][(x >> byte) & 0xFF];
+    }
+}
+
+// Position of the k-th (from 0) set bit of x, or 64 when x has at most k set bits. Broadword
+// select: per-byte popcounts summed into running totals with one multiply, a parallel
+// compare of k against each total to find the byte, then a table lookup within it.
+inline constexpr unsigned selectBit(std::uint64_t x, unsigned k) noexcept
+{
+    const std::uint64_t totals = detail::runningByteCounts(x);
+    if (k >= (totals >> 56))
+    {
+        return 64;
+    }
+    return detail::selectWithCounts(x, totals, k);
+}
+
+// _pdep_u64 without BMI2: the i-th set bit of x moves to the i-th set bit of mask. The byte
+// counts of mask are shared by every bit of x, so each card of a draw costs one compare and
+// one table lookup.
+inline constexpr std::uint64_t depositBitsPortable(std::uint64_t x, std::uint64_t mask) noexcept
+{
+    const std::uint64_t totals = detail::runningByteCounts(mask);
+    const std::uint64_t available = totals >> 56;
+    if (available < 64)
+    {
+        x &= (1ull << available) - 1;
+    }
+    std::uint64_t result = 0;
+    for (; x; x &= x - 1)
+    {
+        result |= 1ull << detail::selectWithCounts(mask, totals, static_cast<unsigned>(std::countr_zero(x)));
+    }
+    return result;
+}
+
+// The path in effect, probing the CPU on first use.
+inline SelectPath selectPath() noexcept
+{
+    SelectPath path = detail::selectPathState.load(std::memory_order_relaxed);
+    if (path == SelectPath::Auto) [[unlikely]]
+    {
+        path = detail::cpuHasFastPdep() ? SelectPath::Pdep : SelectPath::Broadword;
+        detail::selectPathState.store(path, std::memory_order_relaxed);
+    }
+    return path;
+}
+// Forces a path, mainly for benchmarks and tests; Auto re-probes. Pdep falls back to Broadword
+// on CPUs without BMI2. Returns the path now in effect. Deals already running on other
+// threads may finish on either path, which only affects speed.
+inline SelectPath setSelectPath(SelectPath path) noexcept
+{
+    if (path == SelectPath::Auto)
+    {
+        path = detail::cpuHasFastPdep() ? SelectPath::Pdep : SelectPath::Broadword;
+    }
+    else if (path == SelectPath::Pdep && !detail::cpuHasBmi2())
+    {
+        path = SelectPath::Broadword;
+    }
+    detail::selectPathState.store(path, std::memory_order_relaxed);
+    return path;
+}
+
+// Runtime-dispatched _pdep_u64.
+inline std::uint64_t depositBits(std::uint64_t x, std::uint64_t mask) noexcept
+{
+    if (selectPath() == SelectPath::Pdep) [[likely]]
+    {
+        return detail::pdepInstruction(x, mask);
+    }
+    return depositBitsPortable(x, mask);
+}
+#endif // __POKER_BIT_SELECT_HPP__
@@ -0,0 +1,120 @@
+#ifndef __POKER_CHUNK_SCHEDULER_HPP__
+#define __POKER_CHUNK_SCHEDULER_HPP__
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <random>
+#include <stop_token>
+#include <utility>
+#include <vector>
+#include <BS_thread_pool.hpp>
+#include "random.hpp"
+
+struct ChunkRange
+{
+    std::size_t index = 0;
+    std::size_t begin = 0;
+    std::size_t end = 0;
+    inline constexpr std::size_t size() const noexcept { return end - begin; }
+};
+
+// Hands out small chunks of [0, total) through one atomic counter. Workers keep pulling
+// until the range is exhausted, so a slow core only delays the chunk it is holding
+// instead of a whole static share of the work.
+class ChunkScheduler
+{
+private:
+    alignas(64) std::atomic<std::size_t> m_next{0};
+    std::size_t m_total;
+    std::size_t m_chunkSize;
+    std::size_t m_numChunks;
+
+public:
+    static constexpr std::size_t minChunkSize = 64;
+    static constexpr std::size_t maxChunkSize = 4096;
+    static constexpr std::size_t chunksPerWorker = 16;
+    // Worker count assumed when sizing seeded runs. Tying the chunk layout to a fixed count
+    // instead of the local pool keeps seeded totals identical across machines.
+    static constexpr std::size_t seededWorkers = 64;
+
+    inline ChunkScheduler(std::size_t total, std::size_t chunkSize) noexcept
+        : m_total(total), m_chunkSize(std::max<std::size_t>(1, chunkSize)),
+          m_numChunks(total / m_chunkSize + (total % m_chunkSize != 0)) {}
+
+    static inline constexpr std::size_t chunkSizeFor(std::size_t total, std::size_t workers) noexcept
+    {
+        std::size_t target = total / std::max<std::size_t>(1, workers * chunksPerWorker);
+        return std::clamp(target, minChunkSize, maxChunkSize);
+    }
+    inline std::size_t numChunks() const noexcept { return m_numChunks; }
+    inline std::size_t chunkSize() const noexcept { return m_chunkSize; }
+    inline bool claim(ChunkRange &out) noexcept
+    {
+        std::size_t chunk = m_next.fetch_add(1, std::memory_order_relaxed);
+        if (chunk >= m_numChunks)
+        {
+            return false;
+        }
+        std::size_t begin = chunk * m_chunkSize;
+        out = {chunk, begin, std::min(m_total, begin + m_chunkSize)};
+        return true;
+    }
+};
+
+// Every chunk gets its own generator derived from (seed, chunk index), so a seeded run
+// produces the same totals no matter which thread ended up executing which chunk.
+inline constexpr std::uint64_t chunkSeed(std::uint64_t seed, std::size_t chunkIndex) noexcept
+{
+    std::uint64_t x = seed ^ (static_cast<std::uint64_t>(chunkIndex) * 0xD1B54A32D192ED03ull);
+    return omp::splitmix64(x);
+}
+
+inline std::uint64_t randomSeed()
+{
+    std::random_device rd;
+    return (static_cast<std::uint64_t>(rd()) << 32) | rd();
+}
+
+// Runs chunkFn(accumulator, rng, chunk) over [0, total) on the pool plus the calling thread.
+// Each worker folds its chunks into a local TResult; the partial results are merged with
+// operator+= once every worker has drained the scheduler or a stop was requested.
+template <typename TResult, typename TChunkFn>
+inline TResult runChunked(BS::thread_pool<BS::tp::none> &pool, std::size_t total, std::size_t chunkSize, std::uint64_t seed, std::stop_token stopToken, TChunkFn &&chunkFn)
+{
+    const std::size_t poolThreads = pool.get_thread_count();
+    ChunkScheduler scheduler(total, chunkSize);
+    auto worker = [&]()
+    {
+        TResult local{};
+        ChunkRange chunk;
+        while (!stopToken.stop_requested() && scheduler.claim(chunk))
+        {
+            omp::XoroShiro128Plus rng(chunkSeed(seed, chunk.index));
+            chunkFn(local, rng, chunk);
+        }
+        return local;
+    };
+    const std::size_t helpers = std::min(poolThreads, scheduler.numChunks() > 0 ? scheduler.numChunks() - 1 : 0);
+    std::vector<std::future<TResult>> futures;
+    futures.reserve(helpers);
+    for (std::size_t i = 0; i < helpers; ++i)
+    {
+        futures.push_back(pool.submit_task(worker));
+    }
+    TResult result = worker();
+    for (auto &future : futures)
+    {
+        result += future.get();
+    }
+    return result;
+}
+// Chunk size tuned for cheap Monte Carlo trials. It only depends on total, so a seeded run
+// gives the same result on any pool size.
+template <typename TResult, typename TChunkFn>
+inline TResult runChunked(BS::thread_pool<BS::tp::none> &pool, std::size_t total, std::uint64_t seed, std::stop_token stopToken, TChunkFn &&chunkFn)
+{
+    const std::size_t chunkSize = ChunkScheduler::chunkSizeFor(total, ChunkScheduler::seededWorkers);
+    return runChunked<TResult>(pool, total, chunkSize, seed, stopToken, std::forward<TChunkFn>(chunkFn));
+}
+#endif // __POKER_CHUNK_SCHEDULER_HPP__
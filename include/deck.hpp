@@ -1,8 +1,9 @@
 #ifndef __POKER_DECK_HPP__
 #define __POKER_DECK_HPP__
+#include <algorithm>
 #include <array>
 #include <random>
-#include <immintrin.h>
+#include "bit_select.hpp"
 #include "card.hpp"
 #include "random.hpp"
 struct Deck
@@ -38,7 +39,7 @@ private:
     {
         if (!std::is_constant_evaluated())
         {
-            return _pdep_u64(x, mask);
+            return depositBits(x, mask);
         }
         std::uint64_t res = 0;
         for (std::uint64_t m = mask; m; m &= m - 1)
@@ -53,6 +54,38 @@ private:
         return res;
     }
 
+    // m_binomials[n][k] = C(n, k) for n, k <= 52; C(52, 26) still fits in 64 bits.
+    static constexpr std::array<std::array<std::uint64_t, 53>, 53> m_binomials = []()
+    {
+        std::array<std::array<std::uint64_t, 53>, 53> table{};
+        for (std::size_t n = 0; n < table.size(); ++n)
+        {
+            table[n][0] = 1;
+            for (std::size_t k = 1; k <= n; ++k)
+            {
+                table[n][k] = table[n - 1][k - 1] + (k < n ? table[n - 1][k] : 0);
+            }
+        }
+        return table;
+    }();
+    // Mask of the k positions with colex rank i, see index().
+    static inline constexpr std::uint64_t unrank(std::size_t k, std::uint64_t i) noexcept
+    {
+        std::uint64_t mask = 0;
+        std::size_t p = 52;
+        for (std::size_t j = std::min<std::size_t>(k, 52); j > 0; --j)
+        {
+            // Largest position p with C(p, j) <= i; C(j - 1, j) = 0 bounds the search.
+            do
+            {
+                --p;
+            } while (m_binomials[p][j] > i);
+            mask |= 1ull << p;
+            i -= m_binomials[p][j];
+        }
+        return mask;
+    }
+
     constexpr explicit Deck(std::uint64_t mask) : m_cardsBitmask(mask) {}
     static inline constexpr Deck from_mask(std::uint64_t m) noexcept { return Deck(m); }
 
@@ -75,7 +108,69 @@ public:
             return *this;
         }
     };
+    // Walks the k-card subsets of a deck in colex order of their positions within it, by
+    // Gosper's hack on a compact k-of-n mask deposited onto the deck's cards with pdep.
+    // Iterators compare by rank, so a range may start and stop anywhere.
+    struct SubsetIterator
+    {
+        std::uint64_t m_deckMask;
+        std::uint64_t m_compact;
+        std::uint64_t m_rank;
+        inline constexpr bool operator!=(const SubsetIterator &other) const noexcept
+        {
+            return m_rank != other.m_rank;
+        }
+        inline constexpr Deck operator*() const noexcept
+        {
+            return Deck::from_mask(pdep(m_compact, m_deckMask));
+        }
+        inline constexpr SubsetIterator &operator++() noexcept
+        {
+            if (m_compact)
+            {
+                const std::uint64_t lowest = m_compact & -static_cast<std::int64_t>(m_compact);
+                const std::uint64_t ripple = m_compact + lowest;
+                m_compact = ripple | (((m_compact ^ ripple) >> 2) / lowest);
+            }
+            ++m_rank;
+            return *this;
+        }
+        // Colex rank of the current subset among the k-subsets of the deck.
+        inline constexpr std::uint64_t index() const noexcept
+        {
+            return m_rank;
+        }
+    };
+    struct SubsetRange
+    {
+        std::uint64_t m_deckMask;
+        std::size_t m_k;
+        std::uint64_t m_first;
+        std::uint64_t m_last;
+        inline constexpr SubsetIterator begin() const noexcept
+        {
+            return SubsetIterator{m_deckMask, m_first < m_last ? unrank(m_k, m_first) : 0, m_first};
+        }
+        inline constexpr SubsetIterator end() const noexcept
+        {
+            return SubsetIterator{m_deckMask, 0, m_last};
+        }
+        inline constexpr std::uint64_t size() const noexcept
+        {
+            return m_last - m_first;
+        }
+    };
     inline constexpr Deck() = default;
+    // C(n, k) from a constexpr table, 0 when k > n or n > 52.
+    static inline constexpr std::uint64_t binomial(std::size_t n, std::size_t k) noexcept
+    {
+        return n <= 52 && k <= n ? m_binomials[n][k] : 0;
+    }
+    // Inverse of index(): the k-card deck whose colex rank is i, for i < C(52, k).
+    static inline constexpr Deck fromIndex(std::size_t k, std::uint64_t i) noexcept
+    {
+        return Deck::from_mask(unrank(k, i));
+    }
     static inline constexpr Deck createFullDeck() noexcept
     {
         return Deck::from_mask((1ull << 52ull) - 1ull);
@@ -84,6 +179,10 @@ public:
     {
         return Deck::from_mask(0);
     }
+    static inline constexpr Deck fromMask(std::uint64_t mask) noexcept
+    {
+        return Deck::from_mask(mask & ((1ull << 52ull) - 1ull));
+    }
     static inline constexpr Deck createDeck(const std::initializer_list<Deck> decks) noexcept
     {
         std::uint64_t mask = 0;
@@ -217,6 +316,54 @@ public:
         m_cardsBitmask = m_cardsBitmask & ~chosen;
         return out;
     }
+    // Deals numHands (at most 10) two-card hands and numBoardCards more cards added to board.
+    // Each pair is drawn like popPair, but the number of cards left is tracked instead of
+    // recounted, so the random indices do not depend on the previous deal and the only serial
+    // work per pair is one pdep and one mask update. Hands past numHands are empty; dealt
+    // cards are removed from this deck.
+    template <typename TRng>
+    inline constexpr std::array<Deck, 10> dealHands(TRng &rng, std::size_t numHands, Deck &board, std::size_t numBoardCards) noexcept
+    {
+        std::uint64_t mask = m_cardsBitmask;
+        std::size_t remaining = size();
+        auto dealPair = [&]()
+        {
+            const std::uint64_t rand_val = rng();
+            const std::uint64_t idx1 = ((rand_val & 0xFFFFFFFFull) * remaining) >> 32;
+            std::uint64_t idx2 = ((rand_val >> 32) * (remaining - 1)) >> 32;
+            idx2 += idx2 >= idx1;
+            const std::uint64_t bits = pdep((1ull << idx1) | (1ull << idx2), mask);
+            mask &= ~bits;
+            remaining -= 2;
+            return bits;
+        };
+        std::array<Deck, 10> hands{};
+        numHands = std::min<std::size_t>(numHands, 10);
+        for (std::size_t i = 0; i < numHands && remaining >= 2; ++i)
+        {
+            hands[i].m_cardsBitmask = dealPair();
+        }
+        numBoardCards = std::min(numBoardCards, remaining);
+        for (; numBoardCards >= 2; numBoardCards -= 2)
+        {
+            board.m_cardsBitmask |= dealPair();
+        }
+        if (numBoardCards)
+        {
+            const std::uint64_t idx = ((rng() & 0xFFFFFFFFull) * remaining) >> 32;
+            const std::uint64_t bit = pdep(1ull << idx, mask);
+            board.m_cardsBitmask |= bit;
+            mask &= ~bit;
+        }
+        m_cardsBitmask = mask;
+        return hands;
+    }
+    template <typename TRng>
+    inline constexpr std::array<Deck, 10> dealHands(TRng &rng, std::size_t numHands) noexcept
+    {
+        Deck unused = emptyDeck();
+        return dealHands(rng, numHands, unused, 0);
+    }
     template <typename TRng>
     inline Card popRandomCard(TRng &rng)
     {
@@ -261,6 +408,33 @@ public:
     {
         return std::popcount(m_cardsBitmask);
     }
+    // Colex rank among all decks with size() cards: with card positions p_1 < p_2 < ...
+    // (bit indices of the mask), the sum of C(p_j, j). Dense in [0, C(52, size())), so
+    // boards and holdings can index flat arrays instead of hash maps.
+    inline constexpr std::uint64_t index() const noexcept
+    {
+        std::uint64_t rank = 0;
+        std::size_t j = 1;
+        for (std::uint64_t m = m_cardsBitmask; m; m &= m - 1, ++j)
+        {
+            rank += m_binomials[std::countr_zero(m)][j];
+        }
+        return rank;
+    }
+    // Every k-card subset of this deck, C(size(), k) of them.
+    inline constexpr SubsetRange subsets(std::size_t k) const noexcept
+    {
+        return SubsetRange{m_cardsBitmask, k, 0, binomial(size(), k)};
+    }
+    // The k-card subsets of this deck with colex ranks in [first, last), clamped to
+    // C(size(), k). Splitting [0, C(size(), k)) into ranges splits an exact enumeration
+    // evenly across threads.
+    inline constexpr SubsetRange subsets(std::size_t k, std::uint64_t first, std::uint64_t last) const noexcept
+    {
+        const std::uint64_t count = binomial(size(), k);
+        last = std::min(last, count);
+        return SubsetRange{m_cardsBitmask, k, std::min(first, last), last};
+    }
     inline constexpr DeckIterator begin() const noexcept
     {
         return DeckIterator(m_cardsBitmask);
@@ -3,9 +3,15 @@
 #include "classification_result.hpp"
 #include "hand.hpp"
 #include "deck.hpp"
+#include "chunk_scheduler.hpp"
 #include <BS_thread_pool.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <span>
 #include <thread>
+#include <stop_token>
+#include <vector>
 enum class GameResult
 {
     Win,
@@ -34,8 +40,12 @@ inline constexpr GameResult compareHands(const Deck playerCards, const Deck tabl
     }
     return GameResult::Win;
 }
+// Deals the rest of the board and numPlayers - 1 opponent hands, stopping at the first
+// opponent that beats hero, and returns how many players split the pot with hero, hero
+// included: 0 when an opponent is strictly better, 1 for an outright win and k for a k-way
+// tie.
 template <typename TRng>
-inline bool playerWinsRandomGame(TRng &rng, const Deck playerCards, Deck tableCards, Deck deck, std::size_t numPlayers)
+inline std::size_t playRandomGame(TRng &rng, const Deck playerCards, Deck tableCards, Deck deck, std::size_t numPlayers)
 {
     std::size_t numCardsToDeal = 5 - tableCards.size();
     if (numCardsToDeal)
@@ -43,73 +53,203 @@ inline bool playerWinsRandomGame(TRng &rng, const Deck playerCards, Deck tableCa
         tableCards.addCards(deck.popRandomCards(rng, numCardsToDeal));
     }
     ClassificationResult mainResult = Hand::classify(Deck::createDeck({playerCards, tableCards}));
+    std::size_t sharing = 1;
     for (std::size_t i = 0; i < numPlayers - 1; ++i)
     {
         Deck opp = deck.popPair(rng);
         const auto oppResult = Hand::classify(Deck::createDeck({opp, tableCards}));
         if (oppResult > mainResult)
         {
-            return false;
+            return 0;
         }
+        sharing += oppResult == mainResult;
     }
-    return true;
+    return sharing;
+}
+// Win/tie/loss counts and hero's pot share over a set of trials. The share is kept in units
+// of 1/potShareUnits pot; 2520 is the lcm of 1..10, so a k-way split at any table size up to
+// maxPlayers adds an exact integer and merged results do not depend on summation order. The
+// engines below return an empty result for tables outside [2, maxPlayers].
+struct EquityResult
+{
+    static constexpr std::uint64_t potShareUnits = 2520;
+    static constexpr std::size_t maxPlayers = 10;
+    std::uint64_t wins = 0;
+    std::uint64_t ties = 0;
+    std::uint64_t losses = 0;
+    std::uint64_t potShare = 0;
+    // Sum of squared per-trial shares, for the variance of the estimate.
+    std::uint64_t potShareSquares = 0;
+
+    // Records one trial from playRandomGame.
+    inline constexpr void add(std::size_t sharing) noexcept
+    {
+        if (sharing == 0)
+        {
+            ++losses;
+            return;
+        }
+        const std::uint64_t share = potShareUnits / sharing;
+        (sharing == 1 ? wins : ties) += 1;
+        potShare += share;
+        potShareSquares += share * share;
+    }
+    inline constexpr EquityResult &operator+=(const EquityResult &other) noexcept
+    {
+        wins += other.wins;
+        ties += other.ties;
+        losses += other.losses;
+        potShare += other.potShare;
+        potShareSquares += other.potShareSquares;
+        return *this;
+    }
+    inline constexpr std::uint64_t trials() const noexcept { return wins + ties + losses; }
+    // Expected fraction of the pot hero takes down.
+    inline constexpr double equity() const noexcept
+    {
+        return trials() ? static_cast<double>(potShare) / static_cast<double>(potShareUnits * trials()) : 0.0;
+    }
+    inline constexpr double winProbability() const noexcept { return fraction(wins); }
+    inline constexpr double tieProbability() const noexcept { return fraction(ties); }
+    inline constexpr double lossProbability() const noexcept { return fraction(losses); }
+    // Standard error of equity() as a sample mean of per-trial pot shares.
+    inline double standardError() const noexcept
+    {
+        const std::uint64_t n = trials();
+        if (n < 2)
+        {
+            return 0.0;
+        }
+        const double mean = equity();
+        const double meanSquare = static_cast<double>(potShareSquares) / (static_cast<double>(potShareUnits * potShareUnits) * static_cast<double>(n));
+        return std::sqrt(std::max(0.0, meanSquare - mean * mean) / static_cast<double>(n));
+    }
+
+private:
+    inline constexpr double fraction(std::uint64_t count) const noexcept
+    {
+        return trials() ? static_cast<double>(count) / static_cast<double>(trials()) : 0.0;
+    }
+};
+inline constexpr bool supportedTableSize(std::size_t numPlayers) noexcept
+{
+    return numPlayers >= 2 && numPlayers <= EquityResult::maxPlayers;
 }
 template <typename TRng>
-inline constexpr double probabilityOfWinning(TRng &rng, const Deck playerCards, const Deck tableCards, std::size_t numSimulations, std::size_t numPlayers)
+inline constexpr EquityResult simulateEquity(TRng &rng, const Deck playerCards, const Deck tableCards, std::size_t numSimulations, std::size_t numPlayers)
 {
-    std::size_t wins = 0;
+    EquityResult result;
+    if (!supportedTableSize(numPlayers))
+    {
+        return result;
+    }
     Deck deck = Deck::createFullDeck();
     deck.removeCards(playerCards);
     deck.removeCards(tableCards);
     for (std::size_t i = 0; i < numSimulations; ++i)
     {
-        if (playerWinsRandomGame(rng, playerCards, tableCards, deck, numPlayers))
-        {
-            ++wins;
-        }
+        result.add(playRandomGame(rng, playerCards, tableCards, deck, numPlayers));
     }
-    return static_cast<double>(wins) / numSimulations;
+    return result;
+}
+template <typename TRng>
+inline constexpr double probabilityOfWinning(TRng &rng, const Deck playerCards, const Deck tableCards, std::size_t numSimulations, std::size_t numPlayers)
+{
+    return simulateEquity(rng, playerCards, tableCards, numSimulations, numPlayers).equity();
 }
-inline double probabilityOfWinning(const Deck playerCards, const Deck tableCards, std::size_t numSimulations, std::size_t numPlayers, BS::thread_pool<BS::tp::none> &threadPool)
+inline EquityResult simulateWins(const Deck playerCards, const Deck tableCards, std::size_t numSimulations, std::size_t numPlayers, BS::thread_pool<BS::tp::none> &threadPool, std::uint64_t seed, std::stop_token stopToken = {})
 {
-    std::size_t numThreads = threadPool.get_thread_count();
-    std::size_t simulationsPerThread = numSimulations / numThreads;
-    std::vector<std::future<std::size_t>> threads;
-    threads.reserve(numThreads);
-    std::size_t remainingSimulations = numSimulations % numThreads;
+    if (!supportedTableSize(numPlayers))
+    {
+        return {};
+    }
     Deck deck = Deck::createFullDeck();
     deck.removeCards(playerCards);
     deck.removeCards(tableCards);
-    for (std::size_t i = 0; i < numThreads; ++i)
-    {
-        threads.push_back(threadPool.submit_task([&, deck, i]()
-                               {
-            omp::XoroShiro128Plus threadRng(std::random_device{}());
-            std::size_t threadWins = 0;
-            Deck threadDeck = deck;
-            for (std::size_t j = 0; j < simulationsPerThread; ++j)
-            {
-                if (playerWinsRandomGame(threadRng, playerCards, tableCards, threadDeck, numPlayers))
-                {
-                    ++threadWins;
-                }
-            }
-            return threadWins; }));
+    return runChunked<EquityResult>(threadPool, numSimulations, seed, stopToken, [&](EquityResult &result, omp::XoroShiro128Plus &rng, const ChunkRange &chunk)
+                                    {
+        for (std::size_t j = 0; j < chunk.size(); ++j)
+        {
+            result.add(playRandomGame(rng, playerCards, tableCards, deck, numPlayers));
+        } });
+}
+struct SimulationCountsByPlayers
+{
+    static constexpr std::size_t maxPlayers = EquityResult::maxPlayers;
+    // results[n - 2] holds the n-player game of every trial.
+    std::array<EquityResult, maxPlayers - 1> results{};
+    inline constexpr SimulationCountsByPlayers &operator+=(const SimulationCountsByPlayers &other) noexcept
+    {
+        for (std::size_t i = 0; i < results.size(); ++i)
+        {
+            results[i] += other.results[i];
+        }
+        return *this;
+    }
+    inline constexpr EquityResult counts(std::size_t numPlayers) const noexcept
+    {
+        return results[numPlayers - 2];
+    }
+};
+// Deals opponents in the same order as playRandomGame and records the (k + 2)-player game
+// after the k + 1-th opponent, for every k below maxOpponents. Once an opponent beats hero
+// every larger table is a loss, so one trial covers every table size at once.
+template <typename TRng>
+inline void playRandomGameByPlayers(TRng &rng, const Deck playerCards, Deck tableCards, Deck deck, std::size_t maxOpponents, SimulationCountsByPlayers &counts)
+{
+    std::size_t numCardsToDeal = 5 - tableCards.size();
+    if (numCardsToDeal)
+    {
+        tableCards.addCards(deck.popRandomCards(rng, numCardsToDeal));
     }
-    std::size_t wins = 0;
-    omp::XoroShiro128Plus threadRng(std::random_device{}());
-    Deck threadDeck = deck;
-    for (std::size_t i = 0; i < remainingSimulations; ++i)
+    ClassificationResult mainResult = Hand::classify(Deck::createDeck({playerCards, tableCards}));
+    std::size_t sharing = 1;
+    for (std::size_t i = 0; i < maxOpponents; ++i)
     {
-        if (playerWinsRandomGame(threadRng, playerCards, tableCards, threadDeck, numPlayers))
+        Deck opp = deck.popPair(rng);
+        const auto oppResult = Hand::classify(Deck::createDeck({opp, tableCards}));
+        if (oppResult > mainResult)
         {
-            ++wins;
+            for (std::size_t k = i; k < maxOpponents; ++k)
+            {
+                counts.results[k].add(0);
+            }
+            return;
         }
+        sharing += oppResult == mainResult;
+        counts.results[i].add(sharing);
     }
-    for (auto &thread : threads)
+}
+inline SimulationCountsByPlayers simulateWinsByPlayers(const Deck playerCards, const Deck tableCards, std::size_t numSimulations, std::size_t maxPlayers, BS::thread_pool<BS::tp::none> &threadPool, std::uint64_t seed, std::stop_token stopToken = {})
+{
+    Deck deck = Deck::createFullDeck();
+    deck.removeCards(playerCards);
+    deck.removeCards(tableCards);
+    const std::size_t maxOpponents = std::clamp<std::size_t>(maxPlayers, 2, SimulationCountsByPlayers::maxPlayers) - 1;
+    return runChunked<SimulationCountsByPlayers>(threadPool, numSimulations, seed, stopToken, [&](SimulationCountsByPlayers &counts, omp::XoroShiro128Plus &rng, const ChunkRange &chunk)
+                                                 {
+        for (std::size_t j = 0; j < chunk.size(); ++j)
+        {
+            playRandomGameByPlayers(rng, playerCards, tableCards, deck, maxOpponents, counts);
+        } });
+}
+// Equity at every table size from 2 to maxPlayers (at most 10) from one set of trials;
+// element i is the equity with i + 2 players.
+inline std::vector<double> probabilityOfWinningByPlayers(const Deck playerCards, const Deck tableCards, std::size_t numSimulations, std::size_t maxPlayers, BS::thread_pool<BS::tp::none> &threadPool, std::stop_token stopToken = {})
+{
+    maxPlayers = std::clamp<std::size_t>(maxPlayers, 2, SimulationCountsByPlayers::maxPlayers);
+    SimulationCountsByPlayers counts = simulateWinsByPlayers(playerCards, tableCards, numSimulations, maxPlayers, threadPool, randomSeed(), stopToken);
+    std::vector<double> result(maxPlayers - 1);
+    for (std::size_t numPlayers = 2; numPlayers <= maxPlayers; ++numPlayers)
     {
-        wins += thread.get();
+        result[numPlayers - 2] = counts.counts(numPlayers).equity();
     }
-    return static_cast<double>(wins) / numSimulations;
+    return result;
+}
+// Hero's expected share of the pot, split pots counted as 1/k. Stopping early returns the
+// estimate over the trials that completed before the stop.
+inline double probabilityOfWinning(const Deck playerCards, const Deck tableCards, std::size_t numSimulations, std::size_t numPlayers, BS::thread_pool<BS::tp::none> &threadPool, std::stop_token stopToken = {})
+{
+    return simulateWins(playerCards, tableCards, numSimulations, numPlayers, threadPool, randomSeed(), stopToken).equity();
 }
 #endif // __POKER_GAME_HPP__
\ No newline at end of file
@@ -6,8 +6,12 @@
 #include "pot_manager.hpp"
 #include "../classification_result.hpp"
 #include "../hand.hpp"
+#include <array>
+#include <concepts>
 #include <span>
 #include <cstdlib>
+#include <type_traits>
+#include <vector>
 struct BetData
 {
     std::uint32_t pot = 0;
@@ -23,66 +27,193 @@ struct PlayersData
     constexpr PlayersData() = default;
     constexpr PlayersData(std::size_t numberOfPlayers) : dealer(0), current(numberOfPlayers), lastAggressor(numberOfPlayers), toAct(0) {}
 };
-class Game
+// A card source chooses the cards a game deals instead of drawing them at random: anything
+// with Deck draw(Deck &deck, std::size_t count) that removes count cards from deck and
+// returns them, e.g. a recorder that logs the deal or a replayer that feeds it back. Games
+// take the dealing rng as a template, so a card source is passed wherever an rng is.
+template <typename TSource>
+concept CardSource = requires(TSource &source, Deck &deck, std::size_t count) {
+    { source.draw(deck, count) } -> std::same_as<Deck>;
+};
+template <typename TRng>
+inline constexpr Deck drawCards(TRng &rng, Deck &deck, std::size_t count) noexcept
+{
+    if constexpr (CardSource<TRng>)
+    {
+        return rng.draw(deck, count);
+    }
+    else
+    {
+        return deck.popRandomCards(rng, count);
+    }
+}
+
+// What BasicGame::applyAction(rng, action, log) changed, so that undo() can put it back and
+// a depth-first search can walk one game in place instead of copying it at every node. A
+// frame holds the betting state and seat masks from before the action and the cards it
+// dealt; a player is saved only when first touched: the actor, every seat whose bet is
+// cleared at the end of a street, and the winners at payout. Kept outside the game so that
+// games stay trivially copyable.
+class UndoLog
 {
+public:
+    struct SavedPlayer
+    {
+        std::uint32_t chips;
+        std::uint32_t committed;
+        std::uint32_t invested;
+        std::uint8_t seat;
+        bool folded;
+        bool allIn;
+    };
+    struct Frame
+    {
+        ActionStruct action;
+        BetData bet;
+        std::uint64_t dealt;
+        std::uint32_t firstSave;
+        GameState state;
+        std::uint8_t current;
+        std::uint8_t lastAggressor;
+        std::uint8_t toAct;
+        SeatSet alive;
+        SeatSet eligible;
+        SeatSet allIn;
+        // Seats saved by this action, at saves[firstSave, firstSave + saved.size()).
+        SeatSet saved;
+    };
+
+    // frames[0, depth) are applied; frames from depth on were undone and can be redone.
+    std::vector<Frame> frames;
+    // Sized ahead of use, so that saving a player never grows it; only the ranges the
+    // applied frames point at are live.
+    std::vector<SavedPlayer> saves;
+    std::size_t depth = 0;
+
+    inline std::size_t size() const noexcept { return depth; }
+    inline bool empty() const noexcept { return depth == 0; }
+    inline bool canRedo() const noexcept { return depth < frames.size(); }
+    inline void clear() noexcept
+    {
+        frames.clear();
+        saves.clear();
+        depth = 0;
+    }
+};
+
+// Rng wrapper that applyAction(rng, action, log) deals through: forwards the deal to rng and
+// hands the game's pre-change saves to the log.
+template <typename TRng>
+struct UndoRecorder
+{
+    TRng &rng;
+    UndoLog &log;
+
+    inline Deck draw(Deck &deck, std::size_t count) noexcept
+    {
+        const Deck dealt = drawCards(rng, deck, count);
+        log.frames[log.depth - 1].dealt |= dealt.getMask();
+        return dealt;
+    }
+    inline void save(const Player &player) noexcept
+    {
+        UndoLog::Frame &frame = log.frames[log.depth - 1];
+        if (frame.saved.contains(player.id))
+        {
+            return;
+        }
+        log.saves[frame.firstSave + frame.saved.size()] = {player.chips, player.committed, player.invested, static_cast<std::uint8_t>(player.id), player.folded, player.all_in};
+        frame.saved.insert(player.id);
+    }
+};
+
+// Card source that deals a known set of cards again, lowest first, e.g. on redo.
+struct FixedCardSource
+{
+    std::uint64_t remaining = 0;
+
+    inline constexpr Deck draw(Deck &deck, std::size_t count) noexcept
+    {
+        std::uint64_t dealt = 0;
+        for (; count > 0 && remaining; --count)
+        {
+            const std::uint64_t card = remaining & -static_cast<std::int64_t>(remaining);
+            dealt |= card;
+            remaining &= ~card;
+        }
+        deck.removeCards(Deck::fromMask(dealt));
+        return Deck::fromMask(dealt);
+    }
+};
+
+// A table of up to MaxSeats players. Players live in an inline array, so a game is
+// trivially copyable: cloning a state for search or rollouts is a memcpy with no heap
+// traffic. Which seats are alive (dealt in and not folded), eligible (alive and not all-in)
+// and all-in is mirrored in seat masks that change only on deal, fold and all-in, so seat
+// counts are a popcount and finding the next actor is a rotate and a count of trailing
+// zeros. The Player flags stay authoritative for callers; mutablePlayers() is for stacks.
+template <std::size_t MaxSeats>
+class BasicGame
+{
+    static_assert(MaxSeats >= 2, "a game needs at least two seats");
+    static_assert(MaxSeats <= maxTableSeats, "seat sets are 16-bit masks");
+
 private:
     Blinds m_blinds;
     GameState m_state = GameState::PreDeal;
     PlayersData m_playersData;
     BetData m_betData;
     Deck m_board;
-    std::vector<Player> m_players;
+    std::array<Player, MaxSeats> m_players{};
     Deck m_deck = Deck::createFullDeck();
-    inline constexpr std::size_t numberOfPlayers() const noexcept { return m_players.size(); }
+    std::size_t m_numPlayers = 0;
+    SeatSet m_alive;
+    SeatSet m_eligible;
+    SeatSet m_allIn;
+    inline constexpr std::size_t numberOfPlayers() const noexcept { return m_numPlayers; }
     inline constexpr std::size_t leftOf(std::size_t i) const noexcept { return (i + 1) % numberOfPlayers(); }
-    inline constexpr std::size_t countEligible() const noexcept
-    {
-        return std::count_if(m_players.begin(), m_players.end(), [](Player const &p)
-                             { return p.eligible(); });
-    }
-
-    inline constexpr std::size_t countAlive() const noexcept
+    inline constexpr std::size_t countEligible() const noexcept { return m_eligible.size(); }
+    inline constexpr std::size_t countAlive() const noexcept { return m_alive.size(); }
+    inline constexpr std::size_t countEligibleExcluding(std::size_t idx) const noexcept
     {
-        return std::count_if(m_players.begin(), m_players.end(), [](Player const &p)
-                             { return p.alive(); });
+        SeatSet others = m_eligible;
+        others.erase(idx);
+        return others.size();
     }
 
-    inline constexpr std::size_t countEligibleExcluding(std::size_t idx) const noexcept
+    // First seat of seats after i, wrapping around; numberOfPlayers() when there is none.
+    inline constexpr std::size_t nextSeatFrom(std::size_t i, SeatSet seats) const noexcept
     {
-        return std::count_if(m_players.begin(), m_players.end(), [idx](Player const &p)
-                             { return p.eligible() && p.id != idx; });
+        const std::size_t n = numberOfPlayers();
+        const std::size_t next = seats.nextAfter(n == 0 ? 0 : i % n);
+        return next == maxTableSeats ? n : next;
     }
+    inline constexpr std::size_t nextEligibleFrom(std::size_t i) const noexcept { return nextSeatFrom(i, m_eligible); }
+    inline constexpr std::size_t nextAliveFrom(std::size_t i) const noexcept { return nextSeatFrom(i, m_alive); }
 
-    inline constexpr std::size_t nextEligibleFrom(std::size_t i) const noexcept
+    // Hands player's current fields to the undo log when rng carries one.
+    template <typename TRng>
+    inline constexpr void save(TRng &rng, const Player &player) noexcept
     {
-        const std::size_t n = numberOfPlayers();
-        for (std::size_t k = 1; k <= n; ++k)
+        if constexpr (requires { rng.save(player); })
         {
-            std::size_t idx = (i + k) % n;
-            if (m_players[idx].eligible())
-            {
-                return idx;
-            }
+            rng.save(player);
         }
-        return n;
     }
 
-    inline constexpr std::size_t nextAliveFrom(std::size_t i) const noexcept
+    template <typename TRng>
+    inline constexpr void fold(TRng &rng, Player &player) noexcept
     {
-        const std::size_t n = numberOfPlayers();
-        for (std::size_t k = 1; k <= n; ++k)
-        {
-            std::size_t idx = (i + k) % n;
-            if (m_players[idx].alive())
-            {
-                return idx;
-            }
-        }
-        return n;
+        save(rng, player);
+        player.folded = true;
+        m_alive.erase(player.id);
+        m_eligible.erase(player.id);
     }
 
-    inline constexpr void commit(Player &player, std::uint32_t amount) noexcept
+    template <typename TRng>
+    inline constexpr void commit(TRng &rng, Player &player, std::uint32_t amount) noexcept
     {
+        save(rng, player);
         std::uint32_t pay = std::min(amount, player.chips);
         player.chips -= pay;
         player.committed += pay;
@@ -91,58 +222,60 @@ private:
         if (player.chips == 0)
         {
             player.all_in = true;
+            m_allIn.insert(player.id);
+            m_eligible.erase(player.id);
         }
     }
 
-    inline constexpr void resetBettingRound() noexcept
+    template <typename TRng>
+    inline constexpr void resetBettingRound(TRng &rng) noexcept
     {
         m_betData.currentBet = 0;
         m_betData.minRaise = m_blinds.bigBlind; // usual convention
         m_playersData.lastAggressor = numberOfPlayers();
-        for (auto &p : m_players)
+        for (auto &p : mutablePlayers())
         {
-            p.committed = 0;
+            if (p.committed != 0)
+            {
+                save(rng, p);
+                p.committed = 0;
+            }
         }
     }
 
-    inline constexpr bool onlyOneAliveWins() noexcept
+    template <typename TRng>
+    inline constexpr bool onlyOneAliveWins(TRng &rng) noexcept
     {
         if (countAlive() != 1)
         {
             return false;
         }
-        for (auto &player : m_players)
-        {
-            if (!player.alive())
-            {
-                continue;
-            }
-            player.chips += m_betData.pot;
-            m_betData.pot = 0;
-            m_state = GameState::Finished;
-            return true;
-        }
-        return false;
+        Player &winner = m_players[*m_alive.begin()];
+        save(rng, winner);
+        winner.chips += m_betData.pot;
+        m_betData.pot = 0;
+        m_state = GameState::Finished;
+        return true;
     }
 
     template <typename TRng>
     inline constexpr void dealBoard(TRng &rng, std::size_t count) noexcept
     {
-        m_board.addCards(m_deck.popRandomCards(rng, count));
+        m_board.addCards(drawCards(rng, m_deck, count));
     }
     template <typename TRng>
     inline constexpr void executeRound(TRng &rng, GameState newState, std::size_t cardsToDeal) noexcept
     {
         m_state = newState;
         dealBoard(rng, cardsToDeal);
-        resetBettingRound();
+        resetBettingRound(rng);
         m_playersData.current = nextEligibleFrom(m_playersData.dealer);
         m_playersData.toAct = countEligible();
     }
     template <typename TRng>
     inline constexpr void advanceStreet(TRng &rng) noexcept
     {
-        if (onlyOneAliveWins())
+        if (onlyOneAliveWins(rng))
         {
             return;
         }
@@ -164,59 +297,29 @@ private:
             break;
         }
     }
-    inline constexpr void showdownAndPayout() noexcept
+    // Pays every pot to the best hands among its eligible players; odd chips of a split go
+    // to the lowest seats. Everything lives in fixed arrays and seat masks, so a showdown
+    // does not allocate.
+    template <typename TRng>
+    inline constexpr void showdownAndPayout(TRng &rng) noexcept
     {
         const std::size_t n = numberOfPlayers();
-        std::vector<ClassificationResult> hands(n);
-        std::vector<bool> hasHand(n, false);
-        
+        std::array<ClassificationResult, MaxSeats> hands{};
+        SeatSet hasHand;
+
         for (std::size_t i = 0; i < n; ++i)
         {
             if (m_players[i].alive())
             {
-                hands[i] = Hand::classify(Deck::createDeck({m_players[i].hole, m_board}));
-                hasHand[i] = true;
-            }
-        }
-        
-        auto pots = PotManager::build(m_players);
-        for (auto const &pot : pots)
-        {
-            if (pot.amount == 0 || pot.eligiblePlayers.empty())
-            {
-                continue;
-            }
-            
-            ClassificationResult best{};
-            bool first = true;
-            for (std::size_t pi : pot.eligiblePlayers)
-            {
-                if (hasHand[pi] && (first || hands[pi] > best))
-                {
-                    best = hands[pi];
-                    first = false;
-                }
-            }
-            if (first) continue;
-            
-            std::vector<std::size_t> winners;
-            for (std::size_t pi : pot.eligiblePlayers)
-            {
-                if (hasHand[pi] && hands[pi] == best)
-                {
-                    winners.push_back(pi);
-                }
-            }
-            if (winners.empty()) continue;
-            
-            std::sort(winners.begin(), winners.end());
-            std::uint32_t share = pot.amount / static_cast<std::uint32_t>(winners.size());
-            std::uint32_t rem = pot.amount % static_cast<std::uint32_t>(winners.size());
-            for (std::size_t wi = 0; wi < winners.size(); ++wi)
-            {
-                m_players[winners[wi]].chips += share + (wi < rem ? 1 : 0);
+                hands[i] = Hand::classify(Deck::fromMask(m_players[i].hole.getMask() | m_board.getMask()));
+                hasHand.insert(i);
             }
         }
+
+        PotManager::award(PotManager::build(players()), hands, hasHand, [&](std::size_t seat, std::uint32_t chips)
+                          {
+                              save(rng, m_players[seat]);
+                              m_players[seat].chips += chips; });
         m_betData.pot = 0;
         m_state = GameState::Finished;
     }
@@ -252,7 +355,7 @@ private:
         }
         if (m_state == GameState::Showdown)
         {
-            showdownAndPayout();
+            showdownAndPayout(rng);
             return;
         }
         std::size_t n = numberOfPlayers();
@@ -276,11 +379,46 @@ private:
         return bettingRoundMaybeComplete(rng) && m_state == GameState::Finished;
     }
 
+    // Records the state from before a as frames[depth], over the undone frame a redo
+    // replays, then applies a through a recorder that logs every card dealt and player saved.
+    template <typename TRng>
+    inline bool applyJournaled(TRng &rng, const ActionStruct a, UndoLog &log)
+    {
+        const std::uint32_t firstSave = log.depth == 0 ? 0 : static_cast<std::uint32_t>(log.frames[log.depth - 1].firstSave + log.frames[log.depth - 1].saved.size());
+        if (log.saves.size() < firstSave + MaxSeats)
+        {
+            log.saves.resize(std::max<std::size_t>(2 * log.saves.size(), firstSave + MaxSeats));
+        }
+        const UndoLog::Frame frame{a, m_betData, 0, firstSave, m_state,
+                                   static_cast<std::uint8_t>(m_playersData.current), static_cast<std::uint8_t>(m_playersData.lastAggressor),
+                                   static_cast<std::uint8_t>(m_playersData.toAct), m_alive, m_eligible, m_allIn, SeatSet{}};
+        if (log.depth < log.frames.size())
+        {
+            log.frames[log.depth] = frame;
+        }
+        else
+        {
+            log.frames.push_back(frame);
+        }
+        ++log.depth;
+        UndoRecorder<TRng> recorder{rng, log};
+        return applyAction(recorder, a);
+    }
+
 public:
-    constexpr Game(Blinds blinds) noexcept : m_blinds(blinds) {}
-    inline constexpr Player &addPlayer(std::uint32_t chips) noexcept
+    static constexpr std::size_t maxSeats = MaxSeats;
+    constexpr BasicGame(Blinds blinds) noexcept : m_blinds(blinds) {}
+    // Seats a new player at the end of players(); false, leaving the game unchanged, once all
+    // MaxSeats seats are taken.
+    inline constexpr bool addPlayer(std::uint32_t chips) noexcept
     {
-        return m_players.emplace_back(m_players.size(), chips);
+        if (m_numPlayers >= MaxSeats)
+        {
+            return false;
+        }
+        m_players[m_numPlayers] = Player(m_numPlayers, chips);
+        ++m_numPlayers;
+        return true;
     }
     template <typename TRng>
     inline constexpr void startNewHand(TRng &rng) noexcept
@@ -289,7 +427,7 @@ public:
         m_betData.pot = 0;
         m_state = GameState::PreDeal;
         m_deck = Deck::createFullDeck();
-        for (auto &p : m_players)
+        for (auto &p : mutablePlayers())
         {
             p.folded = false;
             p.all_in = false;
@@ -297,6 +435,8 @@ public:
             p.invested = 0;
             p.has_hole = false;
         }
+        m_alive = SeatSet{};
+        m_allIn = SeatSet{};
         for (std::size_t i = 0; i < numberOfPlayers(); ++i)
         {
             if (m_players[i].chips <= 0)
@@ -304,32 +444,38 @@ public:
                 m_players[i].folded = true;
                 continue;
             }
-            m_players[i].hole = m_deck.popRandomCards(rng, 2);
+            m_players[i].hole = drawCards(rng, m_deck, 2);
             m_players[i].has_hole = true;
+            m_alive.insert(i);
         }
+        m_eligible = m_alive;
 
         std::size_t sb = nextAliveFrom(m_playersData.dealer);
         std::size_t bb = nextAliveFrom(sb);
-        commit(m_players[sb], m_blinds.smallBlind);
-        commit(m_players[bb], m_blinds.bigBlind);
+        commit(rng, m_players[sb], m_blinds.smallBlind);
+        commit(rng, m_players[bb], m_blinds.bigBlind);
         m_betData.currentBet = std::min(m_players[bb].committed, m_blinds.bigBlind);
         m_betData.minRaise = m_blinds.bigBlind;
         m_playersData.lastAggressor = bb;
         m_playersData.current = nextEligibleFrom(bb);
         m_playersData.toAct = countEligibleExcluding(bb);
         m_state = GameState::PreFlop;
-        onlyOneAliveWins();
+        onlyOneAliveWins(rng);
     }
     inline constexpr GameState state() const noexcept { return m_state; }
+    inline constexpr const Blinds &blinds() const noexcept { return m_blinds; }
     inline constexpr bool hasCurrentActor() const noexcept { return m_playersData.current != numberOfPlayers(); }
     inline constexpr const Player &currentPlayer() const noexcept { return m_players[m_playersData.current]; }
     inline constexpr const BetData &betData() const noexcept { return m_betData; }
     inline constexpr const Deck &board() const noexcept { return m_board; }
-    inline constexpr std::span<const Player> players() const noexcept { return m_players; }
-    inline constexpr std::span<Player> mutablePlayers() noexcept { return m_players; }
+    inline constexpr SeatSet aliveSeats() const noexcept { return m_alive; }
+    inline constexpr SeatSet eligibleSeats() const noexcept { return m_eligible; }
+    inline constexpr SeatSet allInSeats() const noexcept { return m_allIn; }
+    inline constexpr std::span<const Player> players() const noexcept { return std::span<const Player>(m_players.data(), m_numPlayers); }
+    inline constexpr std::span<Player> mutablePlayers() noexcept { return std::span<Player>(m_players.data(), m_numPlayers); }
     inline constexpr void resetPlayerChips(std::uint32_t chips) noexcept
     {
-        for (auto &p : m_players)
+        for (auto &p : mutablePlayers())
         {
             p.chips = chips;
         }
@@ -344,7 +490,7 @@ public:
 
         if (m_state == GameState::Showdown)
         {
-            showdownAndPayout();
+            showdownAndPayout(rng);
             return true;
         }
         if (m_playersData.current == numberOfPlayers())
@@ -394,8 +540,8 @@ public:
         {
         case ActionType::Fold:
         {
-            current.folded = true;
-            return onlyOneAliveWins() || advanceAndCheckComplete(rng);
+            fold(rng, current);
+            return onlyOneAliveWins(rng) || advanceAndCheckComplete(rng);
         }
 
         case ActionType::Check:
@@ -409,7 +555,7 @@ public:
             {
                 return advanceAndCheckComplete(rng);
             }
-            commit(current, need);
+            commit(rng, current, need);
             return advanceAndCheckComplete(rng);
         }
 
@@ -420,7 +566,7 @@ public:
             {
                 return advanceAndCheckComplete(rng);
             }
-            commit(current, need);
+            commit(rng, current, need);
             return advanceAndCheckComplete(rng);
         }
 
@@ -431,7 +577,7 @@ public:
             {
                 std::uint32_t target = std::max(m_betData.currentBet + m_betData.minRaise, a.amount);
                 std::uint32_t add = std::max(0u, target - current.committed);
-                commit(current, add);
+                commit(rng, current, add);
                 std::uint32_t raise_size = std::max(0u, target - m_betData.currentBet);
                 m_betData.currentBet = std::max(m_betData.currentBet, target);
                 if (raise_size > 0)
@@ -446,7 +592,7 @@ public:
 
             std::uint32_t target = amt;
             std::uint32_t add = std::max(0u, target - current.committed);
-            commit(current, add);
+            commit(rng, current, add);
             m_betData.currentBet = target;
             m_betData.minRaise = amt;
             m_playersData.lastAggressor = m_playersData.current;
@@ -458,7 +604,7 @@ public:
         {
             std::uint32_t target = std::max(m_betData.currentBet + m_betData.minRaise, a.amount);
             std::uint32_t add = std::max(0u, target - current.committed);
-            commit(current, add);
+            commit(rng, current, add);
             std::uint32_t raise_size = std::max(0u, target - m_betData.currentBet);
             m_betData.currentBet = std::max(m_betData.currentBet, target);
             if (raise_size > 0)
@@ -474,7 +620,7 @@ public:
         {
             std::uint32_t target = current.committed + current.chips;
             std::uint32_t add = std::max(0u, target - current.committed);
-            commit(current, add);
+            commit(rng, current, add);
             if (target <= m_betData.currentBet)
             {
                 return advanceAndCheckComplete(rng);
@@ -493,5 +639,60 @@ public:
         }
         return (m_state == GameState::Finished);
     }
+    // applyAction that records into log what undo(log) needs to take it back. Starts a new
+    // line of play, so anything undone before can no longer be redone.
+    template <typename TRng>
+    inline bool applyAction(TRng &rng, const ActionStruct &a, UndoLog &log)
+    {
+        log.frames.resize(log.depth);
+        return applyJournaled(rng, a, log);
+    }
+    // Takes back the last action in log. False when there is none.
+    inline bool undo(UndoLog &log) noexcept
+    {
+        if (log.depth == 0)
+        {
+            return false;
+        }
+        const UndoLog::Frame &frame = log.frames[--log.depth];
+        for (std::size_t i = frame.firstSave; i < frame.firstSave + frame.saved.size(); ++i)
+        {
+            const UndoLog::SavedPlayer &saved = log.saves[i];
+            Player &player = m_players[saved.seat];
+            player.chips = saved.chips;
+            player.committed = saved.committed;
+            player.invested = saved.invested;
+            player.folded = saved.folded;
+            player.all_in = saved.allIn;
+        }
+        m_betData = frame.bet;
+        m_state = frame.state;
+        m_playersData.current = frame.current;
+        m_playersData.lastAggressor = frame.lastAggressor;
+        m_playersData.toAct = frame.toAct;
+        m_alive = frame.alive;
+        m_eligible = frame.eligible;
+        m_allIn = frame.allIn;
+        m_board.removeCards(Deck::fromMask(frame.dealt));
+        m_deck.addCards(Deck::fromMask(frame.dealt));
+        return true;
+    }
+    // Replays the last undone action, dealing the same cards it dealt before. False when
+    // nothing has been undone since the last applyAction(rng, action, log).
+    inline bool redo(UndoLog &log)
+    {
+        if (!log.canRedo())
+        {
+            return false;
+        }
+        const UndoLog::Frame &frame = log.frames[log.depth];
+        FixedCardSource cards{frame.dealt};
+        applyJournaled(cards, frame.action, log);
+        return true;
+    }
 };
+// Full-ring game; search code that only needs heads-up can use BasicGame<2>.
+using Game = BasicGame<10>;
+static_assert(std::is_trivially_copyable_v<Game>);
+static_assert(std::is_trivially_copyable_v<BasicGame<2>> && sizeof(BasicGame<2>) < 200);
 #endif // __POKER_GAME_HPP__
\ No newline at end of file
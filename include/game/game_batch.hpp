@@ -0,0 +1,452 @@
+#ifndef __POKER_GAME_BATCH_HPP__
+#define __POKER_GAME_BATCH_HPP__
+#include "game.hpp"
+#include <algorithm>
+#include <span>
+#include <vector>
+
+// numTables tables of numPlayers seats that step in lockstep, stored as structure of
+// arrays. Per-seat values are seat-major, value(seat, table) at seat * stride + table, so
+// one seat's chips, commitments or hole cards across every table form one contiguous span:
+// the layout batched policy inference and batched hand evaluation read. The stride pads
+// each seat's row by a cache line or two; with power-of-two table counts the rows of one
+// table would otherwise all map to the same L1 sets. Folded and all-in flags are seat
+// masks in each table's betting state, as in Game.
+//
+// Each table follows exactly the rules of BasicGame<MaxSeats>: given the same per-table
+// rng and the same actions, chips match a Game played alone. The one difference is that
+// a table reaching showdown is paid at the end of the step that got it there, together
+// with every other table that reached showdown in that step, instead of on the next
+// applyAction; no cards are dealt at showdown, so the outcome is the same.
+template <std::size_t MaxSeats>
+class BasicGameBatch
+{
+    static_assert(MaxSeats >= 2, "a game needs at least two seats");
+    static_assert(MaxSeats <= maxTableSeats, "seat sets are 16-bit masks");
+
+private:
+    Blinds m_blinds;
+    std::size_t m_numTables = 0;
+    std::size_t m_numPlayers = 0;
+    std::size_t m_stride = 0;
+
+    // Per seat, seat-major.
+    std::vector<std::uint32_t> m_chips;
+    std::vector<std::uint32_t> m_committed;
+    std::vector<std::uint32_t> m_invested;
+    std::vector<std::uint64_t> m_holes;
+
+    // Per table: board and remaining deck as masks, and the betting state every action
+    // reads and writes, packed so that an action touches one cache line of it.
+    std::vector<std::uint64_t> m_boards;
+    std::vector<std::uint64_t> m_decks;
+    struct TableState
+    {
+        GameState state = GameState::PreDeal;
+        std::uint32_t pot = 0;
+        std::uint32_t currentBet = 0;
+        std::uint32_t minRaise = 0;
+        std::uint16_t current = 0;
+        std::uint16_t lastAggressor = 0;
+        std::uint16_t toAct = 0;
+        SeatSet dealt;
+        SeatSet alive;
+        SeatSet eligible;
+        SeatSet allIn;
+    };
+    std::vector<TableState> m_tables;
+
+    // Scratch for batched showdowns, sized for every table at once.
+    std::vector<std::uint32_t> m_showdownTables;
+    std::vector<std::uint64_t> m_showdownCards;
+    std::vector<ClassificationResult> m_showdownHands;
+
+    // The dealer button never moves in Game, so it is seat 0 at every table.
+    static constexpr std::size_t dealer = 0;
+    static inline constexpr bool seatsFit(std::size_t numPlayers) noexcept { return numPlayers >= 2 && numPlayers <= MaxSeats; }
+
+    inline constexpr std::size_t at(std::size_t seat, std::size_t table) const noexcept { return seat * m_stride + table; }
+    inline constexpr std::size_t nextSeatFrom(std::size_t i, SeatSet seats) const noexcept
+    {
+        const std::size_t n = m_numPlayers;
+        const std::size_t next = seats.nextAfter(i % n);
+        return next == maxTableSeats ? n : next;
+    }
+    inline constexpr std::size_t countEligibleExcluding(std::size_t table, std::size_t seat) const noexcept
+    {
+        SeatSet others = m_tables[table].eligible;
+        others.erase(seat);
+        return others.size();
+    }
+
+    inline constexpr void fold(std::size_t table, std::size_t seat) noexcept
+    {
+        m_tables[table].alive.erase(seat);
+        m_tables[table].eligible.erase(seat);
+    }
+    inline constexpr void commit(std::size_t table, std::size_t seat, std::uint32_t amount) noexcept
+    {
+        const std::size_t i = at(seat, table);
+        const std::uint32_t pay = std::min(amount, m_chips[i]);
+        m_chips[i] -= pay;
+        m_committed[i] += pay;
+        m_invested[i] += pay;
+        m_tables[table].pot += pay;
+        if (m_chips[i] == 0)
+        {
+            m_tables[table].allIn.insert(seat);
+            m_tables[table].eligible.erase(seat);
+        }
+    }
+    inline constexpr void resetBettingRound(std::size_t table) noexcept
+    {
+        m_tables[table].currentBet = 0;
+        m_tables[table].minRaise = m_blinds.bigBlind;
+        m_tables[table].lastAggressor = static_cast<std::uint16_t>(m_numPlayers);
+        for (std::size_t seat = 0; seat < m_numPlayers; ++seat)
+        {
+            m_committed[at(seat, table)] = 0;
+        }
+    }
+    inline constexpr bool onlyOneAliveWins(std::size_t table) noexcept
+    {
+        if (m_tables[table].alive.size() != 1)
+        {
+            return false;
+        }
+        m_chips[at(*m_tables[table].alive.begin(), table)] += m_tables[table].pot;
+        m_tables[table].pot = 0;
+        m_tables[table].state = GameState::Finished;
+        return true;
+    }
+
+    template <typename TRng>
+    inline constexpr void executeRound(std::size_t table, TRng &rng, GameState newState, std::size_t cardsToDeal) noexcept
+    {
+        m_tables[table].state = newState;
+        Deck deck = Deck::fromMask(m_decks[table]);
+        m_boards[table] |= drawCards(rng, deck, cardsToDeal).getMask();
+        m_decks[table] = deck.getMask();
+        resetBettingRound(table);
+        m_tables[table].current = static_cast<std::uint16_t>(nextSeatFrom(dealer, m_tables[table].eligible));
+        m_tables[table].toAct = static_cast<std::uint16_t>(m_tables[table].eligible.size());
+    }
+    template <typename TRng>
+    inline constexpr void advanceStreet(std::size_t table, TRng &rng) noexcept
+    {
+        if (onlyOneAliveWins(table))
+        {
+            return;
+        }
+        switch (m_tables[table].state)
+        {
+        case GameState::PreFlop:
+            executeRound(table, rng, GameState::Flop, 3);
+            break;
+        case GameState::Flop:
+            executeRound(table, rng, GameState::Turn, 1);
+            break;
+        case GameState::Turn:
+            executeRound(table, rng, GameState::River, 1);
+            break;
+        case GameState::River:
+            m_tables[table].state = GameState::Showdown;
+            break;
+        default:
+            break;
+        }
+    }
+    template <typename TRng>
+    inline constexpr void bettingRoundMaybeComplete(std::size_t table, TRng &rng) noexcept
+    {
+        if (m_tables[table].toAct > 0)
+        {
+            return;
+        }
+        switch (m_tables[table].state)
+        {
+        case GameState::PreFlop:
+        case GameState::Flop:
+        case GameState::Turn:
+            advanceStreet(table, rng);
+            break;
+        case GameState::River:
+            m_tables[table].state = GameState::Showdown;
+            break;
+        default:
+            break;
+        }
+    }
+    // Showdown tables wait for the end of the step.
+    template <typename TRng>
+    inline constexpr void nextTurn(std::size_t table, TRng &rng) noexcept
+    {
+        if (m_tables[table].state == GameState::Finished || m_tables[table].state == GameState::Showdown)
+        {
+            return;
+        }
+        const std::size_t n = m_numPlayers;
+        const std::size_t from = m_tables[table].current == n ? dealer : m_tables[table].current;
+        const std::size_t next = nextSeatFrom(from, m_tables[table].eligible);
+        m_tables[table].current = static_cast<std::uint16_t>(next);
+        if (next == n)
+        {
+            m_tables[table].toAct = 0;
+            bettingRoundMaybeComplete(table, rng);
+        }
+    }
+    template <typename TRng>
+    inline constexpr void advanceAndCheckComplete(std::size_t table, TRng &rng) noexcept
+    {
+        if (m_tables[table].toAct > 0)
+        {
+            --m_tables[table].toAct;
+        }
+        nextTurn(table, rng);
+        bettingRoundMaybeComplete(table, rng);
+    }
+    // Game::applyAction for one table, less the showdown.
+    template <typename TRng>
+    inline constexpr void applyAction(std::size_t table, TRng &rng, const ActionStruct &a) noexcept
+    {
+        const std::size_t n = m_numPlayers;
+        if (m_tables[table].state == GameState::Finished || m_tables[table].state == GameState::Showdown)
+        {
+            return;
+        }
+        if (m_tables[table].current == n || !m_tables[table].eligible.contains(m_tables[table].current))
+        {
+            nextTurn(table, rng);
+            if (m_tables[table].state == GameState::Finished || m_tables[table].current == n)
+            {
+                return;
+            }
+        }
+        const std::size_t seat = m_tables[table].current;
+        const std::size_t i = at(seat, table);
+        const std::uint32_t toCall = std::max(0u, m_tables[table].currentBet - m_committed[i]);
+
+        switch (a.type)
+        {
+        case ActionType::Fold:
+            fold(table, seat);
+            if (!onlyOneAliveWins(table))
+            {
+                advanceAndCheckComplete(table, rng);
+            }
+            return;
+        case ActionType::Check:
+            // A check facing a bet calls. Game reads the amount as a signed int here, so a
+            // short big blind that leaves the small blind over the bet is a plain check.
+            if (static_cast<int>(toCall) > 0)
+            {
+                commit(table, seat, toCall);
+            }
+            advanceAndCheckComplete(table, rng);
+            return;
+        case ActionType::Call:
+            if (toCall != 0)
+            {
+                commit(table, seat, toCall);
+            }
+            advanceAndCheckComplete(table, rng);
+            return;
+        case ActionType::Bet:
+        case ActionType::Raise:
+        {
+            // A bet into a bet is a raise to at least currentBet + minRaise.
+            const bool opening = a.type == ActionType::Bet && m_tables[table].currentBet == 0;
+            const std::uint32_t target = opening ? std::max(a.amount, m_tables[table].minRaise) : std::max(m_tables[table].currentBet + m_tables[table].minRaise, a.amount);
+            commit(table, seat, std::max(0u, target - m_committed[i]));
+            const std::uint32_t raiseSize = std::max(0u, target - m_tables[table].currentBet);
+            m_tables[table].currentBet = std::max(m_tables[table].currentBet, target);
+            if (opening || raiseSize > 0)
+            {
+                m_tables[table].minRaise = raiseSize;
+            }
+            m_tables[table].lastAggressor = static_cast<std::uint16_t>(seat);
+            m_tables[table].toAct = static_cast<std::uint16_t>(countEligibleExcluding(table, seat));
+            nextTurn(table, rng);
+            return;
+        }
+        case ActionType::AllIn:
+        {
+            const std::uint32_t target = m_committed[i] + m_chips[i];
+            commit(table, seat, m_chips[i]);
+            if (target <= m_tables[table].currentBet)
+            {
+                advanceAndCheckComplete(table, rng);
+                return;
+            }
+            const std::uint32_t raiseSize = target - m_tables[table].currentBet;
+            m_tables[table].currentBet = target;
+            if (raiseSize >= m_tables[table].minRaise)
+            {
+                m_tables[table].minRaise = raiseSize;
+            }
+            m_tables[table].lastAggressor = static_cast<std::uint16_t>(seat);
+            m_tables[table].toAct = static_cast<std::uint16_t>(countEligibleExcluding(table, seat));
+            nextTurn(table, rng);
+            bettingRoundMaybeComplete(table, rng);
+            return;
+        }
+        }
+    }
+
+    // Classifies every live hand of every table at showdown in one pass over a packed
+    // array of card masks, then pays each table's pots.
+    inline void resolveShowdowns() noexcept
+    {
+        std::size_t numTables = 0;
+        std::size_t numHands = 0;
+        for (std::size_t table = 0; table < m_numTables; ++table)
+        {
+            if (m_tables[table].state != GameState::Showdown)
+            {
+                continue;
+            }
+            m_showdownTables[numTables++] = static_cast<std::uint32_t>(table);
+            for (std::size_t seat : m_tables[table].alive)
+            {
+                m_showdownCards[numHands++] = m_holes[at(seat, table)] | m_boards[table];
+            }
+        }
+        for (std::size_t h = 0; h < numHands; ++h)
+        {
+            m_showdownHands[h] = Hand::classify(Deck::fromMask(m_showdownCards[h]));
+        }
+        std::size_t next = 0;
+        for (std::size_t i = 0; i < numTables; ++i)
+        {
+            const std::size_t table = m_showdownTables[i];
+            std::array<ClassificationResult, MaxSeats> hands{};
+            std::array<std::uint32_t, MaxSeats> invested{};
+            for (std::size_t seat : m_tables[table].alive)
+            {
+                hands[seat] = m_showdownHands[next++];
+            }
+            for (std::size_t seat = 0; seat < m_numPlayers; ++seat)
+            {
+                invested[seat] = m_invested[at(seat, table)];
+            }
+            const SidePots pots = PotManager::build(std::span<const std::uint32_t>(invested.data(), m_numPlayers), m_tables[table].alive);
+            PotManager::award(pots, hands, m_tables[table].alive, [&](std::size_t seat, std::uint32_t chips)
+                              { m_chips[at(seat, table)] += chips; });
+            m_tables[table].pot = 0;
+            m_tables[table].state = GameState::Finished;
+        }
+    }
+
+public:
+    static constexpr std::size_t maxSeats = MaxSeats;
+    // A seat count outside [2, MaxSeats] gives an empty batch, numTables() == 0: the
+    // showdown scratch holds MaxSeats seats per table.
+    BasicGameBatch(std::size_t numTables, std::size_t numPlayers, std::uint32_t chips, Blinds blinds)
+        : m_blinds(blinds), m_numTables(seatsFit(numPlayers) ? numTables : 0), m_numPlayers(seatsFit(numPlayers) ? numPlayers : 0),
+          m_stride((m_numTables + 15) / 16 * 16 + 16),
+          m_chips(m_stride * m_numPlayers, chips), m_committed(m_stride * m_numPlayers), m_invested(m_stride * m_numPlayers), m_holes(m_stride * m_numPlayers),
+          m_boards(m_numTables), m_decks(m_numTables, Deck::createFullDeck().getMask()),
+          m_tables(m_numTables),
+          m_showdownTables(m_numTables), m_showdownCards(m_numTables * m_numPlayers), m_showdownHands(m_numTables * m_numPlayers)
+    {
+        for (TableState &table : m_tables)
+        {
+            table.current = static_cast<std::uint16_t>(m_numPlayers);
+            table.lastAggressor = static_cast<std::uint16_t>(m_numPlayers);
+        }
+    }
+
+    // Starts a hand at every table; table t draws from rngs[t].
+    template <typename TRng>
+    inline void startNewHand(std::span<TRng> rngs) noexcept
+    {
+        std::fill(m_committed.begin(), m_committed.end(), 0u);
+        std::fill(m_invested.begin(), m_invested.end(), 0u);
+        for (std::size_t table = 0; table < m_numTables; ++table)
+        {
+            TRng &rng = rngs[table];
+            Deck deck = Deck::createFullDeck();
+            m_boards[table] = 0;
+            m_tables[table].pot = 0;
+            m_tables[table].alive = SeatSet{};
+            m_tables[table].allIn = SeatSet{};
+            for (std::size_t seat = 0; seat < m_numPlayers; ++seat)
+            {
+                const std::size_t i = at(seat, table);
+                m_holes[i] = 0;
+                if (m_chips[i] == 0)
+                {
+                    continue;
+                }
+                m_holes[i] = drawCards(rng, deck, 2).getMask();
+                m_tables[table].alive.insert(seat);
+            }
+            m_decks[table] = deck.getMask();
+            m_tables[table].dealt = m_tables[table].alive;
+            m_tables[table].eligible = m_tables[table].alive;
+
+            const std::size_t sb = nextSeatFrom(dealer, m_tables[table].alive);
+            const std::size_t bb = nextSeatFrom(sb, m_tables[table].alive);
+            commit(table, sb, m_blinds.smallBlind);
+            commit(table, bb, m_blinds.bigBlind);
+            m_tables[table].currentBet = std::min(m_committed[at(bb, table)], m_blinds.bigBlind);
+            m_tables[table].minRaise = m_blinds.bigBlind;
+            m_tables[table].lastAggressor = static_cast<std::uint16_t>(bb);
+            m_tables[table].current = static_cast<std::uint16_t>(nextSeatFrom(bb, m_tables[table].eligible));
+            m_tables[table].toAct = static_cast<std::uint16_t>(countEligibleExcluding(table, bb));
+            m_tables[table].state = GameState::PreFlop;
+            onlyOneAliveWins(table);
+        }
+    }
+    // Applies actions[t] at every unfinished table t, to its current actor, or just moves
+    // the table on when nobody can act (as Game::applyAction does); then pays out every
+    // table that reached showdown. Returns the number of tables still playing.
+    template <typename TRng>
+    inline std::size_t step(std::span<TRng> rngs, std::span<const ActionStruct> actions) noexcept
+    {
+        bool anyShowdown = false;
+        std::size_t running = 0;
+        for (std::size_t table = 0; table < m_numTables; ++table)
+        {
+            if (m_tables[table].state == GameState::Finished)
+            {
+                continue;
+            }
+            applyAction(table, rngs[table], actions[table]);
+            anyShowdown |= m_tables[table].state == GameState::Showdown;
+            running += m_tables[table].state != GameState::Finished;
+        }
+        if (anyShowdown)
+        {
+            running -= static_cast<std::size_t>(std::count_if(m_tables.begin(), m_tables.end(), [](const TableState &t)
+                                                              { return t.state == GameState::Showdown; }));
+            resolveShowdowns();
+        }
+        return running;
+    }
+
+    inline constexpr std::size_t numTables() const noexcept { return m_numTables; }
+    inline constexpr std::size_t numPlayers() const noexcept { return m_numPlayers; }
+    inline constexpr GameState state(std::size_t table) const noexcept { return m_tables[table].state; }
+    inline constexpr bool hasCurrentActor(std::size_t table) const noexcept { return m_tables[table].current != m_numPlayers; }
+    // Seat to act at table, numPlayers() when nobody can.
+    inline constexpr std::size_t currentSeat(std::size_t table) const noexcept { return m_tables[table].current; }
+    inline constexpr BetData betData(std::size_t table) const noexcept { return {m_tables[table].pot, m_tables[table].currentBet, m_tables[table].minRaise}; }
+    inline constexpr SeatSet aliveSeats(std::size_t table) const noexcept { return m_tables[table].alive; }
+    inline constexpr SeatSet eligibleSeats(std::size_t table) const noexcept { return m_tables[table].eligible; }
+    inline constexpr SeatSet allInSeats(std::size_t table) const noexcept { return m_tables[table].allIn; }
+    // Dealt in this hand and folded since.
+    inline constexpr SeatSet foldedSeats(std::size_t table) const noexcept { return SeatSet::fromMask(m_tables[table].dealt.bits & ~m_tables[table].alive.bits); }
+
+    // One value per table.
+    inline constexpr std::span<const std::uint64_t> boards() const noexcept { return m_boards; }
+    // One seat across every table.
+    inline constexpr std::span<const std::uint32_t> chips(std::size_t seat) const noexcept { return {m_chips.data() + at(seat, 0), m_numTables}; }
+    inline constexpr std::span<const std::uint32_t> committed(std::size_t seat) const noexcept { return {m_committed.data() + at(seat, 0), m_numTables}; }
+    inline constexpr std::span<const std::uint64_t> holes(std::size_t seat) const noexcept { return {m_holes.data() + at(seat, 0), m_numTables}; }
+    inline constexpr std::uint32_t chips(std::size_t seat, std::size_t table) const noexcept { return m_chips[at(seat, table)]; }
+    inline constexpr std::uint32_t committed(std::size_t seat, std::size_t table) const noexcept { return m_committed[at(seat, table)]; }
+    inline constexpr void resetPlayerChips(std::uint32_t chips) noexcept { std::fill(m_chips.begin(), m_chips.end(), chips); }
+};
+using GameBatch = BasicGameBatch<10>;
+#endif // __POKER_GAME_BATCH_HPP__
@@ -0,0 +1,421 @@
+#ifndef __POKER_HAND_HISTORY_HPP__
+#define __POKER_HAND_HISTORY_HPP__
+#include <array>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <span>
+#include <vector>
+#include "game.hpp"
+#include "../mapped_file.hpp"
+
+// On-disk layout: this header, then one record per hand, appended as the hand finishes.
+// A record is a u32 byte count of the rest of the record, then, with every number a
+// LEB128 varint unless noted:
+//   seat count, small blind, big blind, then each seat's stack before the blinds;
+//   the card count, then one byte (its mask bit) per card in dealing order, each draw in
+//   ascending bit order: hole cards seat by seat, then the board;
+//   the actions until the end of the record: a u8 ActionType, and the amount for Bet and
+//   Raise, which are the only actions that read it.
+// A six-handed hand takes around 60 bytes. A record is written whole, so a file cut short
+// by a crash loses at most the record being written, which readers skip.
+struct HandHistoryHeader
+{
+    std::array<char, 8> magic = {'P', 'K', 'R', 'H', 'A', 'N', 'D', 'S'};
+    std::uint32_t version = 1;
+    std::uint32_t reserved = 0;
+};
+static_assert(sizeof(HandHistoryHeader) == 16 && std::is_trivially_copyable_v<HandHistoryHeader>);
+
+namespace detail
+{
+    inline void appendVarint(std::vector<std::uint8_t> &out, std::uint32_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<std::uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<std::uint8_t>(value));
+    }
+    // Reads a varint at pos and advances it; false when the bytes run out first.
+    inline constexpr bool readVarint(std::span<const std::uint8_t> bytes, std::size_t &pos, std::uint32_t &value) noexcept
+    {
+        value = 0;
+        for (unsigned shift = 0; shift < 35 && pos < bytes.size(); shift += 7)
+        {
+            const std::uint8_t byte = bytes[pos++];
+            value |= static_cast<std::uint32_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+    inline constexpr bool actionHasAmount(ActionType type) noexcept
+    {
+        return type == ActionType::Bet || type == ActionType::Raise;
+    }
+}
+
+// Card source that deals at random from rng and logs every card dealt.
+template <typename TRng>
+struct RecordingCardSource
+{
+    TRng &rng;
+    std::vector<std::uint8_t> &cards;
+
+    inline Deck draw(Deck &deck, std::size_t count)
+    {
+        const Deck dealt = deck.popRandomCards(rng, count);
+        for (std::uint64_t m = dealt.getMask(); m; m &= m - 1)
+        {
+            cards.push_back(static_cast<std::uint8_t>(std::countr_zero(m)));
+        }
+        return dealt;
+    }
+};
+
+// Card source that deals a recorded hand's cards back in order; no rng involved.
+struct ReplayCardSource
+{
+    std::span<const std::uint8_t> cards;
+    std::size_t next = 0;
+
+    inline constexpr Deck draw(Deck &deck, std::size_t count) noexcept
+    {
+        std::uint64_t mask = 0;
+        for (; count > 0 && next < cards.size(); --count)
+        {
+            mask |= 1ull << (cards[next++] % 52);
+        }
+        const Deck dealt = Deck::fromMask(mask);
+        deck.removeCards(dealt);
+        return dealt;
+    }
+};
+
+// Plays hands through a game and appends each finished hand to an append-only file. Use
+// startNewHand and applyAction in place of the game's own; they deal from rng as usual and
+// log the deal, the stacks and the actions. Records go through a buffered stream, so a
+// failed write is reported by flush rather than by the action that finished the hand.
+class HandRecorder
+{
+private:
+    std::ofstream m_file;
+    std::vector<std::uint8_t> m_prefix;
+    std::vector<std::uint8_t> m_cards;
+    std::vector<std::uint8_t> m_actions;
+    std::vector<std::uint8_t> m_record;
+    bool m_recording = false;
+    bool m_writeFailed = false;
+    std::size_t m_handsWritten = 0;
+
+    template <std::size_t MaxSeats>
+    inline void finishIfDone(const BasicGame<MaxSeats> &game)
+    {
+        if (!m_recording || game.state() != GameState::Finished)
+        {
+            return;
+        }
+        m_record.clear();
+        const std::size_t bodySize = m_prefix.size() + m_cards.size() + m_actions.size() + 1;
+        const std::uint32_t size = static_cast<std::uint32_t>(bodySize);
+        m_record.resize(sizeof(size));
+        std::memcpy(m_record.data(), &size, sizeof(size));
+        m_record.insert(m_record.end(), m_prefix.begin(), m_prefix.end());
+        m_record.push_back(static_cast<std::uint8_t>(m_cards.size()));
+        m_record.insert(m_record.end(), m_cards.begin(), m_cards.end());
+        m_record.insert(m_record.end(), m_actions.begin(), m_actions.end());
+        m_file.write(reinterpret_cast<const char *>(m_record.data()), static_cast<std::streamsize>(m_record.size()));
+        m_recording = false;
+        if (!m_file)
+        {
+            m_writeFailed = true;
+            return;
+        }
+        ++m_handsWritten;
+    }
+
+public:
+    // Opens path for appending, writing the header to a new or empty file. Returns
+    // std::nullopt when the file cannot be opened or holds something else.
+    static inline std::optional<HandRecorder> open(const char *path)
+    {
+        HandRecorder recorder;
+        bool empty = true;
+        if (std::ifstream existing(path, std::ios::binary); existing.is_open())
+        {
+            HandHistoryHeader header;
+            existing.read(reinterpret_cast<char *>(&header), sizeof(header));
+            empty = existing.gcount() == 0;
+            if (!empty && (existing.gcount() != sizeof(header) || header.magic != HandHistoryHeader{}.magic || header.version != 1))
+            {
+                return std::nullopt;
+            }
+        }
+        recorder.m_file.open(path, std::ios::binary | std::ios::app);
+        if (!recorder.m_file)
+        {
+            return std::nullopt;
+        }
+        if (empty)
+        {
+            const HandHistoryHeader header;
+            recorder.m_file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        }
+        return recorder;
+    }
+
+    template <std::size_t MaxSeats, typename TRng>
+    inline void startNewHand(BasicGame<MaxSeats> &game, TRng &rng)
+    {
+        m_prefix.clear();
+        m_cards.clear();
+        m_actions.clear();
+        detail::appendVarint(m_prefix, static_cast<std::uint32_t>(game.players().size()));
+        detail::appendVarint(m_prefix, game.blinds().smallBlind);
+        detail::appendVarint(m_prefix, game.blinds().bigBlind);
+        for (const Player &p : game.players())
+        {
+            detail::appendVarint(m_prefix, p.chips);
+        }
+        m_recording = true;
+        RecordingCardSource<TRng> source{rng, m_cards};
+        game.startNewHand(source);
+        finishIfDone(game);
+    }
+    template <std::size_t MaxSeats, typename TRng>
+    inline bool applyAction(BasicGame<MaxSeats> &game, TRng &rng, const ActionStruct &a)
+    {
+        if (m_recording)
+        {
+            m_actions.push_back(static_cast<std::uint8_t>(a.type));
+            if (detail::actionHasAmount(a.type))
+            {
+                detail::appendVarint(m_actions, a.amount);
+            }
+        }
+        RecordingCardSource<TRng> source{rng, m_cards};
+        const bool finished = game.applyAction(source, a);
+        finishIfDone(game);
+        return finished;
+    }
+    // False when any record since open could not be written in full; the log may then end
+    // in a truncated record, which readers skip.
+    inline bool flush()
+    {
+        m_file.flush();
+        m_writeFailed |= !m_file;
+        return !m_writeFailed;
+    }
+    // Hands whose record reached the stream without error.
+    inline std::size_t handsWritten() const noexcept { return m_handsWritten; }
+};
+
+// One recorded hand, viewed in place in the mapped file.
+class HandRecord
+{
+private:
+    std::span<const std::uint8_t> m_cards;
+    std::span<const std::uint8_t> m_actions;
+    std::array<std::uint32_t, maxTableSeats> m_stacks{};
+    std::size_t m_numSeats = 0;
+    Blinds m_blinds{};
+
+public:
+    // Returns std::nullopt when body is not a well-formed record.
+    static inline constexpr std::optional<HandRecord> parse(std::span<const std::uint8_t> body) noexcept
+    {
+        HandRecord record;
+        std::size_t pos = 0;
+        std::uint32_t value = 0;
+        if (!detail::readVarint(body, pos, value) || value < 2 || value > maxTableSeats)
+        {
+            return std::nullopt;
+        }
+        record.m_numSeats = value;
+        if (!detail::readVarint(body, pos, record.m_blinds.smallBlind) || !detail::readVarint(body, pos, record.m_blinds.bigBlind))
+        {
+            return std::nullopt;
+        }
+        for (std::size_t i = 0; i < record.m_numSeats; ++i)
+        {
+            if (!detail::readVarint(body, pos, record.m_stacks[i]))
+            {
+                return std::nullopt;
+            }
+        }
+        if (pos >= body.size() || body[pos] > 52 || body.size() - pos - 1 < body[pos])
+        {
+            return std::nullopt;
+        }
+        record.m_cards = body.subspan(pos + 1, body[pos]);
+        record.m_actions = body.subspan(pos + 1 + body[pos]);
+        return record;
+    }
+
+    inline constexpr std::size_t numSeats() const noexcept { return m_numSeats; }
+    inline constexpr const Blinds &blinds() const noexcept { return m_blinds; }
+    inline constexpr std::span<const std::uint32_t> stacks() const noexcept { return {m_stacks.data(), m_numSeats}; }
+    inline constexpr std::span<const std::uint8_t> cards() const noexcept { return m_cards; }
+
+    // Decodes the action stream front to back.
+    struct ActionReader
+    {
+        std::span<const std::uint8_t> bytes;
+        std::size_t pos = 0;
+        // False at the end of the stream or on a malformed action.
+        inline constexpr bool next(ActionStruct &action) noexcept
+        {
+            if (pos >= bytes.size() || bytes[pos] > static_cast<std::uint8_t>(ActionType::AllIn))
+            {
+                return false;
+            }
+            action = {static_cast<ActionType>(bytes[pos++]), 0};
+            return !detail::actionHasAmount(action.type) || detail::readVarint(bytes, pos, action.amount);
+        }
+    };
+    inline constexpr ActionReader actions() const noexcept { return {m_actions}; }
+    inline constexpr std::size_t numActions() const noexcept
+    {
+        ActionReader reader = actions();
+        ActionStruct action{ActionType::Fold, 0};
+        std::size_t count = 0;
+        while (reader.next(action))
+        {
+            ++count;
+        }
+        return count;
+    }
+};
+
+// Rebuilds a recorded hand action by action from the log alone: the deal comes from the
+// record, so no rng runs and every state matches the original game exactly.
+template <std::size_t MaxSeats>
+class BasicHandReplay
+{
+private:
+    BasicGame<MaxSeats> m_game;
+    ReplayCardSource m_source;
+    HandRecord::ActionReader m_actions;
+    std::size_t m_position = 0;
+
+    inline constexpr explicit BasicHandReplay(const HandRecord &record) noexcept
+        : m_game(record.blinds()), m_source{record.cards()}, m_actions(record.actions())
+    {
+        for (const std::uint32_t chips : record.stacks())
+        {
+            m_game.addPlayer(chips);
+        }
+        m_game.startNewHand(m_source);
+    }
+
+public:
+    // The game just after the deal and blinds, before any action. Returns std::nullopt when
+    // record has more seats than this replay's game holds.
+    static inline constexpr std::optional<BasicHandReplay> create(const HandRecord &record) noexcept
+    {
+        if (record.numSeats() > MaxSeats)
+        {
+            return std::nullopt;
+        }
+        return BasicHandReplay(record);
+    }
+    // Applies the next recorded action; false once the record is exhausted.
+    inline constexpr bool step() noexcept
+    {
+        ActionStruct action{ActionType::Fold, 0};
+        if (!m_actions.next(action))
+        {
+            return false;
+        }
+        m_game.applyAction(m_source, action);
+        ++m_position;
+        return true;
+    }
+    // Steps until count actions have been applied in total, or the record ends.
+    inline constexpr void advanceTo(std::size_t count) noexcept
+    {
+        while (m_position < count && step())
+        {
+        }
+    }
+    inline constexpr const BasicGame<MaxSeats> &game() const noexcept { return m_game; }
+    // Number of actions applied so far.
+    inline constexpr std::size_t position() const noexcept { return m_position; }
+};
+using HandReplay = BasicHandReplay<Game::maxSeats>;
+
+// The game after the first count actions of record, or after the whole hand by default.
+// std::nullopt when record has more than MaxSeats seats.
+template <std::size_t MaxSeats = Game::maxSeats>
+inline constexpr std::optional<BasicGame<MaxSeats>> replayHand(const HandRecord &record, std::size_t count = std::numeric_limits<std::size_t>::max()) noexcept
+{
+    std::optional<BasicHandReplay<MaxSeats>> replay = BasicHandReplay<MaxSeats>::create(record);
+    if (!replay)
+    {
+        return std::nullopt;
+    }
+    replay->advanceTo(count);
+    return replay->game();
+}
+
+// Memory-mapped, read-only view of a file written by HandRecorder, indexed for random
+// access to any hand.
+class HandHistory
+{
+private:
+    MappedFile m_file;
+    std::vector<std::size_t> m_offsets;
+
+    inline std::span<const std::uint8_t> body(std::size_t hand) const noexcept
+    {
+        const std::uint8_t *data = reinterpret_cast<const std::uint8_t *>(m_file.bytes().data());
+        std::uint32_t size = 0;
+        std::memcpy(&size, data + m_offsets[hand], sizeof(size));
+        return {data + m_offsets[hand] + sizeof(size), size};
+    }
+
+public:
+    // Returns std::nullopt when the file is missing or not a hand history. A truncated
+    // last record is left out.
+    static inline std::optional<HandHistory> open(const char *path)
+    {
+        std::optional<MappedFile> file = MappedFile::open(path);
+        if (!file || file->size() < sizeof(HandHistoryHeader))
+        {
+            return std::nullopt;
+        }
+        HandHistoryHeader header;
+        std::memcpy(&header, file->bytes().data(), sizeof(header));
+        if (header.magic != HandHistoryHeader{}.magic || header.version != 1)
+        {
+            return std::nullopt;
+        }
+        HandHistory history;
+        const std::size_t total = file->size();
+        std::size_t pos = sizeof(HandHistoryHeader);
+        while (total - pos >= sizeof(std::uint32_t))
+        {
+            std::uint32_t size = 0;
+            std::memcpy(&size, file->bytes().data() + pos, sizeof(size));
+            if (total - pos - sizeof(size) < size)
+            {
+                break;
+            }
+            history.m_offsets.push_back(pos);
+            pos += sizeof(size) + size;
+        }
+        history.m_file = std::move(*file);
+        return history;
+    }
+
+    inline std::size_t size() const noexcept { return m_offsets.size(); }
+    // std::nullopt when the hand's record is corrupt.
+    inline std::optional<HandRecord> operator[](std::size_t hand) const noexcept { return HandRecord::parse(body(hand)); }
+};
+#endif // __POKER_HAND_HISTORY_HPP__
@@ -1,65 +1,144 @@
 #ifndef __POKER_POT_MANAGER_HPP__
 #define __POKER_POT_MANAGER_HPP__
-#include <vector>
+#include <array>
 #include <cstddef>
-#include <algorithm>
 #include <span>
 #include "player.hpp"
+#include "seat_set.hpp"
+#include "../classification_result.hpp"
 struct SidePot
 {
     std::uint32_t amount = 0;
-    std::vector<std::size_t> eligiblePlayers;
+    SeatSet eligiblePlayers;
+};
+// The pots of one hand, main pot first. There is at most one pot per distinct investment
+// level, so maxTableSeats entries always suffice and building them never allocates.
+struct SidePots
+{
+    std::array<SidePot, maxTableSeats> pots{};
+    std::size_t count = 0;
+    inline constexpr std::size_t size() const noexcept { return count; }
+    inline constexpr bool empty() const noexcept { return count == 0; }
+    inline constexpr const SidePot &operator[](std::size_t i) const noexcept { return pots[i]; }
+    inline constexpr const SidePot *begin() const noexcept { return pots.data(); }
+    inline constexpr const SidePot *end() const noexcept { return pots.data() + count; }
 };
 struct PotManager
 {
-    static constexpr std::vector<SidePot> build(std::span<const Player> players)
+    // players may hold at most maxTableSeats entries.
+    static constexpr SidePots build(std::span<const Player> players) noexcept
     {
-        const std::size_t n = players.size();
-        if (n == 0) return {};
-        
-        std::vector<std::uint32_t> levels;
-        levels.reserve(n);
-        for (const auto& p : players)
+        std::array<std::uint32_t, maxTableSeats> invested{};
+        SeatSet alive;
+        for (std::size_t i = 0; i < players.size(); ++i)
         {
-            if (p.invested > 0)
+            invested[i] = players[i].invested;
+            if (players[i].alive())
             {
-                levels.push_back(p.invested);
+                alive.insert(i);
             }
         }
-        if (levels.empty()) return {};
-        
-        std::sort(levels.begin(), levels.end());
-        levels.erase(std::unique(levels.begin(), levels.end()), levels.end());
-        
-        std::vector<SidePot> pots;
-        pots.reserve(levels.size());
-        
+        return build(std::span<const std::uint32_t>(invested.data(), players.size()), alive);
+    }
+    // Seat i put invested[i] in the pot; only alive seats can win a pot.
+    static constexpr SidePots build(std::span<const std::uint32_t> invested, SeatSet alive) noexcept
+    {
+        SidePots pots;
+        const std::size_t n = invested.size();
+
+        // Distinct non-zero investments in ascending order, by insertion.
+        std::array<std::uint32_t, maxTableSeats> levels{};
+        std::size_t numLevels = 0;
+        for (const std::uint32_t amount : invested)
+        {
+            if (amount == 0)
+            {
+                continue;
+            }
+            std::size_t at = numLevels;
+            while (at > 0 && levels[at - 1] > amount)
+            {
+                --at;
+            }
+            if (at > 0 && levels[at - 1] == amount)
+            {
+                continue;
+            }
+            for (std::size_t j = numLevels; j > at; --j)
+            {
+                levels[j] = levels[j - 1];
+            }
+            levels[at] = amount;
+            ++numLevels;
+        }
+
         std::uint32_t prevCap = 0;
-        for (std::uint32_t cap : levels)
+        for (std::size_t l = 0; l < numLevels; ++l)
         {
+            const std::uint32_t cap = levels[l];
             const std::uint32_t delta = cap - prevCap;
             SidePot pot;
-            pot.eligiblePlayers.reserve(n);
-            
             for (std::size_t i = 0; i < n; ++i)
             {
-                if (players[i].invested > prevCap)
+                if (invested[i] > prevCap)
                 {
                     pot.amount += delta;
                 }
-                if (players[i].alive() && players[i].invested >= cap)
+                if (alive.contains(i) && invested[i] >= cap)
                 {
-                    pot.eligiblePlayers.push_back(i);
+                    pot.eligiblePlayers.insert(i);
                 }
             }
-            
             if (pot.amount > 0 && !pot.eligiblePlayers.empty())
             {
-                pots.push_back(std::move(pot));
+                pots.pots[pots.count++] = pot;
             }
             prevCap = cap;
         }
         return pots;
     }
+    // Pays every pot to the best hands among its eligible seats in hasHand, calling
+    // pay(seat, chips); odd chips of a split go to the lowest seats.
+    template <typename TPay>
+    static constexpr void award(const SidePots &pots, std::span<const ClassificationResult> hands, SeatSet hasHand, TPay &&pay) noexcept
+    {
+        for (auto const &pot : pots)
+        {
+            const SeatSet contenders = pot.eligiblePlayers & hasHand;
+            if (pot.amount == 0 || contenders.empty())
+            {
+                continue;
+            }
+
+            ClassificationResult best{};
+            bool first = true;
+            for (std::size_t pi : contenders)
+            {
+                if (first || hands[pi] > best)
+                {
+                    best = hands[pi];
+                    first = false;
+                }
+            }
+
+            SeatSet winners;
+            for (std::size_t pi : contenders)
+            {
+                if (hands[pi] == best)
+                {
+                    winners.insert(pi);
+                }
+            }
+
+            const std::uint32_t numWinners = static_cast<std::uint32_t>(winners.size());
+            std::uint32_t share = pot.amount / numWinners;
+            std::uint32_t rem = pot.amount % numWinners;
+            std::uint32_t wi = 0;
+            for (std::size_t pi : winners)
+            {
+                pay(pi, share + (wi++ < rem ? 1 : 0));
+            }
+        }
+    }
 };
-#endif // __POKER_POT_MANAGER_HPP__
\ No newline at end of file
+#endif // __POKER_POT_MANAGER_HPP__
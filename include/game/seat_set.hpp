@@ -0,0 +1,55 @@
+#ifndef __POKER_SEAT_SET_HPP__
+#define __POKER_SEAT_SET_HPP__
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+// Largest table the engine supports; seat sets are 16-bit masks.
+inline constexpr std::size_t maxTableSeats = 16;
+
+// A set of seat indices as a bitmask, bit i for seat i. Iteration yields the seats in
+// ascending order, so it can stand in for a sorted std::vector<std::size_t> of seats.
+struct SeatSet
+{
+    std::uint16_t bits = 0;
+
+    struct Iterator
+    {
+        std::uint32_t remaining;
+        inline constexpr std::size_t operator*() const noexcept { return static_cast<std::size_t>(std::countr_zero(remaining)); }
+        inline constexpr Iterator &operator++() noexcept
+        {
+            remaining &= remaining - 1;
+            return *this;
+        }
+        inline constexpr bool operator!=(const Iterator &other) const noexcept { return remaining != other.remaining; }
+    };
+
+    static inline constexpr SeatSet fromMask(std::uint32_t mask) noexcept { return SeatSet{static_cast<std::uint16_t>(mask)}; }
+    // Seats [0, count).
+    static inline constexpr SeatSet firstSeats(std::size_t count) noexcept { return fromMask((1u << count) - 1u); }
+
+    inline constexpr Iterator begin() const noexcept { return Iterator{bits}; }
+    inline constexpr Iterator end() const noexcept { return Iterator{0}; }
+    inline constexpr std::size_t size() const noexcept { return static_cast<std::size_t>(std::popcount(bits)); }
+    inline constexpr bool empty() const noexcept { return bits == 0; }
+    inline constexpr bool contains(std::size_t seat) const noexcept { return (bits >> seat) & 1u; }
+    inline constexpr void insert(std::size_t seat) noexcept { bits = static_cast<std::uint16_t>(bits | (1u << seat)); }
+    inline constexpr void erase(std::size_t seat) noexcept { bits = static_cast<std::uint16_t>(bits & ~(1u << seat)); }
+    // First seat after seat, wrapping around, or maxTableSeats when the set is empty: rotate
+    // the seats after it down to bit 0 and take the lowest. The seat itself comes last.
+    inline constexpr std::size_t nextAfter(std::size_t seat) const noexcept
+    {
+        const int shift = static_cast<int>((seat + 1) % maxTableSeats);
+        const std::uint16_t rotated = std::rotr(bits, shift);
+        if (rotated == 0)
+        {
+            return maxTableSeats;
+        }
+        return (static_cast<std::size_t>(std::countr_zero(rotated)) + static_cast<std::size_t>(shift)) % maxTableSeats;
+    }
+    inline constexpr SeatSet operator&(SeatSet other) const noexcept { return fromMask(bits & other.bits); }
+    inline constexpr SeatSet operator|(SeatSet other) const noexcept { return fromMask(bits | other.bits); }
+    inline constexpr bool operator==(const SeatSet &other) const noexcept = default;
+};
+#endif // __POKER_SEAT_SET_HPP__
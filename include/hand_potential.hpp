@@ -0,0 +1,237 @@
+#ifndef __POKER_HAND_POTENTIAL_HPP__
+#define __POKER_HAND_POTENTIAL_HPP__
+#include <array>
+#include <vector>
+#include "hand_strength.hpp"
+
+struct HandPotential
+{
+    double handStrength = 0.0;
+    double positivePotential = 0.0;
+    double negativePotential = 0.0;
+    // Billings' optimistic effective hand strength: EHS = HS + (1 - HS) * PPot.
+    inline constexpr double effectiveHandStrength() const noexcept
+    {
+        return handStrength + (1.0 - handStrength) * positivePotential;
+    }
+};
+
+namespace detail
+{
+    enum PotentialOutcome : std::size_t
+    {
+        Ahead = 0,
+        Tied = 1,
+        Behind = 2,
+    };
+    inline constexpr std::size_t potentialOutcome(ClassificationResult hero, ClassificationResult opponent) noexcept
+    {
+        return hero > opponent ? Ahead : (hero == opponent ? Tied : Behind);
+    }
+    struct PotentialCounts
+    {
+        // transitions[now][final], one entry per (opponent holding, runout).
+        std::array<std::array<std::uint64_t, 3>, 3> transitions{};
+        inline constexpr PotentialCounts &operator+=(const PotentialCounts &other) noexcept
+        {
+            for (std::size_t i = 0; i < 3; ++i)
+            {
+                for (std::size_t j = 0; j < 3; ++j)
+                {
+                    transitions[i][j] += other.transitions[i][j];
+                }
+            }
+            return *this;
+        }
+    };
+    // Colex rank of a sorted subset {i0 < i1 < ...} is sum C(i_m, m + 1).
+    inline constexpr auto potentialBinomials = []()
+    {
+        std::array<std::array<std::uint32_t, 5>, 53> table{};
+        for (std::size_t n = 0; n < table.size(); ++n)
+        {
+            for (std::size_t k = 0; k < 5; ++k)
+            {
+                table[n][k] = static_cast<std::uint32_t>(Deck::binomial(n, k));
+            }
+        }
+        return table;
+    }();
+    inline constexpr std::uint32_t colex(std::uint32_t a) noexcept
+    {
+        return potentialBinomials[a][1];
+    }
+    inline constexpr std::uint32_t colex(std::uint32_t a, std::uint32_t b) noexcept
+    {
+        return potentialBinomials[a][1] + potentialBinomials[b][2];
+    }
+    inline constexpr std::uint32_t colex(std::uint32_t a, std::uint32_t b, std::uint32_t c) noexcept
+    {
+        return potentialBinomials[a][1] + potentialBinomials[b][2] + potentialBinomials[c][3];
+    }
+    inline constexpr std::uint32_t colex(std::uint32_t a, std::uint32_t b, std::uint32_t c, std::uint32_t d) noexcept
+    {
+        return potentialBinomials[a][1] + potentialBinomials[b][2] + potentialBinomials[c][3] + potentialBinomials[d][4];
+    }
+}
+
+// Billings-style positive/negative potential for hero against one random opponent, looking
+// one or two cards ahead from a flop or turn board (river boards only report hand strength).
+//
+// Every final 7-card opponent hand is board + a (2 + lookahead)-subset of the remaining
+// cards, and that subset is shared by C(2 + lookahead, 2) (holding, runout) pairs. The
+// engine classifies each subset once into a dense colex-indexed table, classifies hero's
+// runouts once, and the transition tally over holdings x runouts is then table lookups
+// only, run in parallel over opponent holdings.
+inline HandPotential handPotential(const Deck playerCards, const Deck tableCards, std::size_t lookahead, BS::thread_pool<BS::tp::none> &threadPool)
+{
+    HandPotential result;
+    if (tableCards.size() < 3 || tableCards.size() > 5)
+    {
+        return result;
+    }
+    lookahead = std::min<std::size_t>(lookahead, 5 - tableCards.size());
+    lookahead = std::min<std::size_t>(lookahead, 2);
+
+    Deck deck = Deck::createFullDeck();
+    deck.removeCards(playerCards);
+    deck.removeCards(tableCards);
+    std::array<std::uint64_t, 52> cardBits{};
+    std::uint32_t remaining = 0;
+    for (std::uint64_t m = deck.getMask(); m; m &= m - 1)
+    {
+        cardBits[remaining++] = m & -static_cast<std::int64_t>(m);
+    }
+    const std::uint64_t boardMask = tableCards.getMask();
+    const std::uint64_t heroBoardMask = boardMask | playerCards.getMask();
+    const std::size_t poolWorkers = threadPool.get_thread_count() + 1;
+
+    // Opponent 2 + lookahead card subsets, chunked by their highest card.
+    const std::size_t subsetSize = 2 + lookahead;
+    std::vector<ClassificationResult> opponentFinal(Deck::binomial(remaining, subsetSize));
+    runChunked<int>(threadPool, remaining, 1, 0, {}, [&](int &, omp::XoroShiro128Plus &, const ChunkRange &chunk)
+                    {
+        for (std::uint32_t top = static_cast<std::uint32_t>(chunk.begin); top < chunk.end; ++top)
+        {
+            for (std::uint32_t a = 0; a < top; ++a)
+            {
+                if (subsetSize == 2)
+                {
+                    opponentFinal[detail::colex(a, top)] = Hand::classify(Deck::fromMask(boardMask | cardBits[a] | cardBits[top]));
+                    continue;
+                }
+                for (std::uint32_t b = a + 1; b < top; ++b)
+                {
+                    if (subsetSize == 3)
+                    {
+                        opponentFinal[detail::colex(a, b, top)] = Hand::classify(Deck::fromMask(boardMask | cardBits[a] | cardBits[b] | cardBits[top]));
+                        continue;
+                    }
+                    for (std::uint32_t c = b + 1; c < top; ++c)
+                    {
+                        opponentFinal[detail::colex(a, b, c, top)] = Hand::classify(Deck::fromMask(boardMask | cardBits[a] | cardBits[b] | cardBits[c] | cardBits[top]));
+                    }
+                }
+            }
+        } });
+
+    // Hero's final hand only depends on the runout.
+    std::vector<ClassificationResult> heroFinal(Deck::binomial(remaining, lookahead));
+    if (lookahead == 0)
+    {
+        heroFinal[0] = Hand::classify(Deck::fromMask(heroBoardMask));
+    }
+    for (std::uint32_t c = 0; lookahead > 0 && c < remaining; ++c)
+    {
+        if (lookahead == 1)
+        {
+            heroFinal[detail::colex(c)] = Hand::classify(Deck::fromMask(heroBoardMask | cardBits[c]));
+            continue;
+        }
+        for (std::uint32_t d = c + 1; d < remaining; ++d)
+        {
+            heroFinal[detail::colex(c, d)] = Hand::classify(Deck::fromMask(heroBoardMask | cardBits[c] | cardBits[d]));
+        }
+    }
+
+    const ClassificationResult heroNow = Hand::classify(Deck::fromMask(heroBoardMask));
+    const std::size_t holdings = Deck::binomial(remaining, 2);
+    const std::size_t chunkSize = std::max<std::size_t>(1, holdings / (poolWorkers * 4));
+    detail::PotentialCounts counts = runChunked<detail::PotentialCounts>(threadPool, holdings, chunkSize, 0, {}, [&](detail::PotentialCounts &acc, omp::XoroShiro128Plus &, const ChunkRange &chunk)
+                                                                         {
+        // Holding index i is the colex rank of (a, b); walk pairs from the chunk start.
+        std::uint32_t b = 1;
+        while (detail::colex(0, b + 1) <= chunk.begin)
+        {
+            ++b;
+        }
+        std::uint32_t a = static_cast<std::uint32_t>(chunk.begin - detail::colex(0, b));
+        for (std::size_t i = chunk.begin; i < chunk.end; ++i)
+        {
+            const ClassificationResult oppNow = Hand::classify(Deck::fromMask(boardMask | cardBits[a] | cardBits[b]));
+            auto &row = acc.transitions[detail::potentialOutcome(heroNow, oppNow)];
+            if (lookahead == 0)
+            {
+                ++row[detail::potentialOutcome(heroNow, oppNow)];
+            }
+            for (std::uint32_t c = 0; lookahead > 0 && c < remaining; ++c)
+            {
+                if (c == a || c == b)
+                {
+                    continue;
+                }
+                if (lookahead == 1)
+                {
+                    const std::uint32_t lo = std::min(a, c);
+                    const std::uint32_t hi = std::max(b, c);
+                    const std::uint32_t mid = c < a ? a : (c > b ? b : c);
+                    ++row[detail::potentialOutcome(heroFinal[detail::colex(c)], opponentFinal[detail::colex(lo, mid, hi)])];
+                    continue;
+                }
+                for (std::uint32_t d = c + 1; d < remaining; ++d)
+                {
+                    if (d == a || d == b)
+                    {
+                        continue;
+                    }
+                    // Merge the sorted pairs (a, b) and (c, d).
+                    const std::uint32_t s0 = std::min(a, c);
+                    const std::uint32_t s3 = std::max(b, d);
+                    const std::uint32_t m1 = std::max(a, c);
+                    const std::uint32_t m2 = std::min(b, d);
+                    ++row[detail::potentialOutcome(heroFinal[detail::colex(c, d)], opponentFinal[detail::colex(s0, std::min(m1, m2), std::max(m1, m2), s3)])];
+                }
+            }
+            if (++a == b)
+            {
+                a = 0;
+                ++b;
+            }
+        } });
+
+    using detail::Ahead, detail::Tied, detail::Behind;
+    const auto &hp = counts.transitions;
+    std::array<double, 3> totals{};
+    for (std::size_t now = 0; now < 3; ++now)
+    {
+        totals[now] = static_cast<double>(hp[now][Ahead] + hp[now][Tied] + hp[now][Behind]);
+    }
+    const double all = totals[Ahead] + totals[Tied] + totals[Behind];
+    if (all == 0.0)
+    {
+        return result;
+    }
+    result.handStrength = (totals[Ahead] + totals[Tied] / 2.0) / all;
+    const double positiveBase = totals[Behind] + totals[Tied] / 2.0;
+    const double negativeBase = totals[Ahead] + totals[Tied] / 2.0;
+    if (positiveBase > 0.0)
+    {
+        result.positivePotential = (static_cast<double>(hp[Behind][Ahead]) + static_cast<double>(hp[Behind][Tied]) / 2.0 + static_cast<double>(hp[Tied][Ahead]) / 2.0) / positiveBase;
+    }
+    if (negativeBase > 0.0)
+    {
+        result.negativePotential = (static_cast<double>(hp[Ahead][Behind]) + static_cast<double>(hp[Tied][Behind]) / 2.0 + static_cast<double>(hp[Ahead][Tied]) / 2.0) / negativeBase;
+    }
+    return result;
+}
+#endif // __POKER_HAND_POTENTIAL_HPP__
@@ -0,0 +1,221 @@
+#ifndef __POKER_HAND_RANGE_HPP__
+#define __POKER_HAND_RANGE_HPP__
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <immintrin.h>
+#include "deck.hpp"
+#include "starting_hands.hpp"
+
+namespace detail
+{
+    // The 1326 combos padded to whole 8-float AVX2 lanes, and to whole 4-word blocks in the
+    // blocker bitsets.
+    inline constexpr std::size_t rangeLanes = (comboCount + 7) / 8;
+    inline constexpr std::size_t rangeSize = rangeLanes * 8;
+    inline constexpr std::size_t blockerWords = (rangeSize + 255) / 256 * 4;
+    using ComboBits = std::array<std::uint64_t, blockerWords>;
+
+    // comboBlockers[card]: bit i is set when combo i holds the card at mask bit `card`.
+    alignas(32) inline constexpr std::array<ComboBits, 52> comboBlockers = []()
+    {
+        std::array<ComboBits, 52> table{};
+        for (std::size_t i = 0; i < comboCount; ++i)
+        {
+            for (std::size_t card : comboCards[i])
+            {
+                table[card][i / 64] |= 1ull << (i % 64);
+            }
+        }
+        return table;
+    }();
+}
+
+// Weights of the 1326 hole-card combos in canonical order (see comboIndex), 0 for combos
+// outside the range. A plain range is weights of 0 and 1; union and intersection are then
+// the usual set operations and otherwise take the larger and smaller weight per combo.
+// Storage is padded to whole AVX2 lanes, so every operation is a few hundred vector
+// instructions instead of a loop of per-combo mask tests.
+struct HandRange
+{
+private:
+    alignas(32) std::array<float, detail::rangeSize> m_weights{};
+
+    enum class Combine
+    {
+        Max,
+        Min,
+        Multiply,
+    };
+    template <Combine op>
+    inline constexpr HandRange &combine(const HandRange &other) noexcept
+    {
+#ifdef __AVX2__
+        if (!std::is_constant_evaluated())
+        {
+            for (std::size_t i = 0; i < detail::rangeSize; i += 8)
+            {
+                const __m256 lhs = _mm256_load_ps(m_weights.data() + i);
+                const __m256 rhs = _mm256_load_ps(other.m_weights.data() + i);
+                __m256 result;
+                if constexpr (op == Combine::Max)
+                {
+                    result = _mm256_max_ps(lhs, rhs);
+                }
+                else if constexpr (op == Combine::Min)
+                {
+                    result = _mm256_min_ps(lhs, rhs);
+                }
+                else
+                {
+                    result = _mm256_mul_ps(lhs, rhs);
+                }
+                _mm256_store_ps(m_weights.data() + i, result);
+            }
+            return *this;
+        }
+#endif
+        for (std::size_t i = 0; i < detail::rangeSize; ++i)
+        {
+            const float lhs = m_weights[i];
+            const float rhs = other.m_weights[i];
+            if constexpr (op == Combine::Max)
+            {
+                m_weights[i] = lhs < rhs ? rhs : lhs;
+            }
+            else if constexpr (op == Combine::Min)
+            {
+                m_weights[i] = rhs < lhs ? rhs : lhs;
+            }
+            else
+            {
+                m_weights[i] = lhs * rhs;
+            }
+        }
+        return *this;
+    }
+
+public:
+    inline constexpr HandRange() = default;
+    // Every combo at weight 1.
+    static inline constexpr HandRange full() noexcept
+    {
+        HandRange range;
+        for (std::size_t i = 0; i < comboCount; ++i)
+        {
+            range.m_weights[i] = 1.0f;
+        }
+        return range;
+    }
+    static inline constexpr HandRange fromWeights(const std::span<const float, comboCount> weights) noexcept
+    {
+        HandRange range;
+        for (std::size_t i = 0; i < comboCount; ++i)
+        {
+            range.m_weights[i] = weights[i];
+        }
+        return range;
+    }
+    // Every combo weighted by its starting-hand class, indexed by StartingHandClass::index().
+    static inline constexpr HandRange fromClasses(const std::span<const float, startingHandClassCount> classWeights) noexcept
+    {
+        HandRange range;
+        for (std::size_t i = 0; i < comboCount; ++i)
+        {
+            range.m_weights[i] = classWeights[comboClasses[i]];
+        }
+        return range;
+    }
+
+    inline constexpr float operator[](std::size_t combo) const noexcept { return m_weights[combo]; }
+    inline constexpr float weight(const Deck combo) const noexcept { return m_weights[comboIndex(combo.getMask())]; }
+    inline constexpr void set(std::size_t combo, float weight) noexcept { m_weights[combo] = weight; }
+    inline constexpr void set(const Deck combo, float weight) noexcept { m_weights[comboIndex(combo.getMask())] = weight; }
+    // Sets every combo of a starting-hand class.
+    inline constexpr void set(const StartingHandClass handClass, float weight) noexcept
+    {
+        const StartingHandCombos &combos = startingHandCombos[handClass.index()];
+        for (std::size_t i = 0; i < combos.count; ++i)
+        {
+            m_weights[comboIndex(combos.masks[i])] = weight;
+        }
+    }
+    inline constexpr std::span<const float, comboCount> weights() const noexcept
+    {
+        return std::span<const float, comboCount>(m_weights.data(), comboCount);
+    }
+
+    // Number of combos with a non-zero weight.
+    inline constexpr std::size_t size() const noexcept
+    {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < comboCount; ++i)
+        {
+            count += m_weights[i] != 0.0f;
+        }
+        return count;
+    }
+    inline constexpr double totalWeight() const noexcept
+    {
+        double total = 0.0;
+        for (std::size_t i = 0; i < comboCount; ++i)
+        {
+            total += m_weights[i];
+        }
+        return total;
+    }
+
+    // Union: the larger weight of each combo.
+    inline constexpr HandRange &operator|=(const HandRange &other) noexcept { return combine<Combine::Max>(other); }
+    // Intersection: the smaller weight of each combo.
+    inline constexpr HandRange &operator&=(const HandRange &other) noexcept { return combine<Combine::Min>(other); }
+    // Combo-wise product, e.g. a range times the frequency of one action.
+    inline constexpr HandRange &operator*=(const HandRange &other) noexcept { return combine<Combine::Multiply>(other); }
+    friend inline constexpr HandRange operator|(HandRange lhs, const HandRange &rhs) noexcept { return lhs |= rhs; }
+    friend inline constexpr HandRange operator&(HandRange lhs, const HandRange &rhs) noexcept { return lhs &= rhs; }
+    friend inline constexpr HandRange operator*(HandRange lhs, const HandRange &rhs) noexcept { return lhs *= rhs; }
+
+    // Zeroes every combo that shares a card with cards (a board, hero's hand, or both): the
+    // per-card blocker bitsets are OR-ed together, then each 8-combo byte of the result is
+    // widened to a lane mask that clears the blocked weights.
+    inline constexpr HandRange &removeBlocked(const Deck cards) noexcept
+    {
+        alignas(32) detail::ComboBits blocked{};
+        for (std::uint64_t m = cards.getMask(); m; m &= m - 1)
+        {
+            const detail::ComboBits &blockers = detail::comboBlockers[std::countr_zero(m) % 52];
+            for (std::size_t w = 0; w < blocked.size(); ++w)
+            {
+                blocked[w] |= blockers[w];
+            }
+        }
+#ifdef __AVX2__
+        if (!std::is_constant_evaluated())
+        {
+            const __m256i laneBits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+            for (std::size_t lane = 0; lane < detail::rangeLanes; ++lane)
+            {
+                const int byte = static_cast<int>((blocked[lane / 8] >> (8 * (lane % 8))) & 0xFF);
+                const __m256i hit = _mm256_and_si256(_mm256_set1_epi32(byte), laneBits);
+                const __m256 keep = _mm256_castsi256_ps(_mm256_cmpeq_epi32(hit, _mm256_setzero_si256()));
+                float *weights = m_weights.data() + lane * 8;
+                _mm256_store_ps(weights, _mm256_and_ps(_mm256_load_ps(weights), keep));
+            }
+            return *this;
+        }
+#endif
+        for (std::size_t i = 0; i < comboCount; ++i)
+        {
+            if (blocked[i / 64] & (1ull << (i % 64)))
+            {
+                m_weights[i] = 0.0f;
+            }
+        }
+        return *this;
+    }
+
+    inline constexpr bool operator==(const HandRange &other) const noexcept = default;
+};
+#endif // __POKER_HAND_RANGE_HPP__
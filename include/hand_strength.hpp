@@ -0,0 +1,148 @@
+#ifndef __POKER_HAND_STRENGTH_HPP__
+#define __POKER_HAND_STRENGTH_HPP__
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+#include "game.hpp"
+
+template <std::size_t Bins = 10>
+struct HandStrengthDistribution
+{
+    // Fraction of runouts whose river hand strength falls in [i / Bins, (i + 1) / Bins).
+    std::array<double, Bins> histogram{};
+    double ehs = 0.0;
+    double ehs2 = 0.0;
+    std::size_t runouts = 0;
+    bool exact = false;
+};
+
+// Hand strength of a complete 5-card board against every holding of one random opponent,
+// ties counted as half. Raised to the number of opponents for multiway pots.
+inline double riverHandStrength(const Deck playerCards, const Deck board, std::size_t numPlayers) noexcept
+{
+    const ClassificationResult heroResult = Hand::classify(Deck::createDeck({playerCards, board}));
+    Deck deck = Deck::createFullDeck();
+    deck.removeCards(playerCards);
+    deck.removeCards(board);
+    const std::uint64_t boardMask = board.getMask();
+    std::size_t ahead = 0;
+    std::size_t tied = 0;
+    std::size_t total = 0;
+    for (std::uint64_t first = deck.getMask(); first; first &= first - 1)
+    {
+        const std::uint64_t firstBit = first & -static_cast<std::int64_t>(first);
+        for (std::uint64_t second = first & (first - 1); second; second &= second - 1)
+        {
+            const std::uint64_t secondBit = second & -static_cast<std::int64_t>(second);
+            const ClassificationResult oppResult = Hand::classify(Deck::fromMask(boardMask | firstBit | secondBit));
+            ahead += heroResult > oppResult;
+            tied += heroResult == oppResult;
+            ++total;
+        }
+    }
+    const double strength = (static_cast<double>(ahead) + 0.5 * static_cast<double>(tied)) / static_cast<double>(total);
+    return std::pow(strength, static_cast<double>(numPlayers > 1 ? numPlayers - 1 : 1));
+}
+
+namespace detail
+{
+    template <std::size_t Bins>
+    struct StrengthAccumulator
+    {
+        std::array<double, Bins> histogram{};
+        double weight = 0.0;
+        double sum = 0.0;
+        double sumSquares = 0.0;
+        inline constexpr StrengthAccumulator &operator+=(const StrengthAccumulator &other) noexcept
+        {
+            for (std::size_t i = 0; i < Bins; ++i)
+            {
+                histogram[i] += other.histogram[i];
+            }
+            weight += other.weight;
+            sum += other.sum;
+            sumSquares += other.sumSquares;
+            return *this;
+        }
+    };
+}
+
+// Distribution of hero's river hand strength over the remaining runouts. When there are at
+// most maxRunouts distinct river boards they are enumerated exactly; otherwise maxRunouts
+// boards are sampled. Either way every distinct river board is evaluated once and weighted
+// by how many runouts reach it, so turn/river orderings of the same cards share one
+// inner evaluation.
+template <std::size_t Bins = 10>
+inline HandStrengthDistribution<Bins> handStrengthDistribution(const Deck playerCards, const Deck tableCards, std::size_t numPlayers, std::size_t maxRunouts, BS::thread_pool<BS::tp::none> &threadPool, std::uint64_t seed = randomSeed())
+{
+    Deck deck = Deck::createFullDeck();
+    deck.removeCards(playerCards);
+    deck.removeCards(tableCards);
+    const std::size_t missing = 5 - std::min<std::size_t>(5, tableCards.size());
+    const std::size_t distinct = Deck::binomial(deck.size(), missing);
+
+    std::vector<std::uint64_t> boards;
+    std::vector<std::uint32_t> weights;
+    HandStrengthDistribution<Bins> result;
+    result.exact = distinct <= maxRunouts;
+    if (result.exact)
+    {
+        boards.reserve(distinct);
+        for (const Deck runout : deck.subsets(missing))
+        {
+            boards.push_back(tableCards.getMask() | runout.getMask());
+        }
+        weights.assign(boards.size(), 1);
+    }
+    else
+    {
+        omp::XoroShiro128Plus rng(seed);
+        std::vector<std::uint64_t> samples(maxRunouts);
+        for (auto &sample : samples)
+        {
+            Deck runoutDeck = deck;
+            sample = tableCards.getMask() | runoutDeck.popRandomCards(rng, missing).getMask();
+        }
+        std::sort(samples.begin(), samples.end());
+        for (std::uint64_t sample : samples)
+        {
+            if (!boards.empty() && boards.back() == sample)
+            {
+                ++weights.back();
+                continue;
+            }
+            boards.push_back(sample);
+            weights.push_back(1);
+        }
+    }
+    if (boards.empty())
+    {
+        return result;
+    }
+
+    using Accumulator = detail::StrengthAccumulator<Bins>;
+    const std::size_t chunkSize = std::max<std::size_t>(1, boards.size() / ((threadPool.get_thread_count() + 1) * 4));
+    Accumulator total = runChunked<Accumulator>(threadPool, boards.size(), chunkSize, seed, {}, [&](Accumulator &acc, omp::XoroShiro128Plus &, const ChunkRange &chunk)
+                                                {
+        for (std::size_t i = chunk.begin; i < chunk.end; ++i)
+        {
+            const double strength = riverHandStrength(playerCards, Deck::fromMask(boards[i]), numPlayers);
+            const double weight = static_cast<double>(weights[i]);
+            const std::size_t bin = std::min(Bins - 1, static_cast<std::size_t>(strength * Bins));
+            acc.histogram[bin] += weight;
+            acc.weight += weight;
+            acc.sum += weight * strength;
+            acc.sumSquares += weight * strength * strength;
+        } });
+
+    for (std::size_t i = 0; i < Bins; ++i)
+    {
+        result.histogram[i] = total.histogram[i] / total.weight;
+    }
+    result.ehs = total.sum / total.weight;
+    result.ehs2 = total.sumSquares / total.weight;
+    result.runouts = static_cast<std::size_t>(total.weight);
+    return result;
+}
+#endif // __POKER_HAND_STRENGTH_HPP__
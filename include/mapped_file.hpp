@@ -0,0 +1,134 @@
+#ifndef __POKER_MAPPED_FILE_HPP__
+#define __POKER_MAPPED_FILE_HPP__
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <utility>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Read-only memory mapping of a whole file. Move-only; the view is released on destruction.
+class MappedFile
+{
+private:
+    const std::byte *m_data = nullptr;
+    std::size_t m_size = 0;
+#ifdef _WIN32
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = nullptr;
+#endif
+
+    inline void release() noexcept
+    {
+#ifdef _WIN32
+        if (m_data)
+        {
+            UnmapViewOfFile(m_data);
+        }
+        if (m_mapping)
+        {
+            CloseHandle(m_mapping);
+        }
+        if (m_file != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(m_file);
+        }
+        m_mapping = nullptr;
+        m_file = INVALID_HANDLE_VALUE;
+#else
+        if (m_data)
+        {
+            munmap(const_cast<std::byte *>(m_data), m_size);
+        }
+#endif
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+public:
+    inline MappedFile() noexcept = default;
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    inline MappedFile(MappedFile &&other) noexcept { *this = std::move(other); }
+    inline MappedFile &operator=(MappedFile &&other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+#ifdef _WIN32
+            m_file = std::exchange(other.m_file, INVALID_HANDLE_VALUE);
+            m_mapping = std::exchange(other.m_mapping, nullptr);
+#endif
+        }
+        return *this;
+    }
+    inline ~MappedFile() { release(); }
+
+    // Returns std::nullopt when the file cannot be opened or mapped, or is empty.
+    static inline std::optional<MappedFile> open(const char *path) noexcept
+    {
+        MappedFile file;
+#ifdef _WIN32
+        file.m_file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file.m_file == INVALID_HANDLE_VALUE)
+        {
+            return std::nullopt;
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file.m_file, &size) || size.QuadPart <= 0)
+        {
+            return std::nullopt;
+        }
+        file.m_mapping = CreateFileMappingA(file.m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!file.m_mapping)
+        {
+            return std::nullopt;
+        }
+        file.m_data = static_cast<const std::byte *>(MapViewOfFile(file.m_mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!file.m_data)
+        {
+            return std::nullopt;
+        }
+        file.m_size = static_cast<std::size_t>(size.QuadPart);
+#else
+        const int fd = ::open(path, O_RDONLY);
+        if (fd < 0)
+        {
+            return std::nullopt;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size <= 0)
+        {
+            ::close(fd);
+            return std::nullopt;
+        }
+        void *data = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED)
+        {
+            return std::nullopt;
+        }
+        file.m_data = static_cast<const std::byte *>(data);
+        file.m_size = static_cast<std::size_t>(info.st_size);
+#endif
+        return file;
+    }
+
+    inline std::span<const std::byte> bytes() const noexcept { return {m_data, m_size}; }
+    inline std::size_t size() const noexcept { return m_size; }
+};
+#endif // __POKER_MAPPED_FILE_HPP__
@@ -8,10 +8,14 @@
 #include <cmath>
 #include <random>
 
-constexpr int kInputDims = 32; // Increased for richer features
+// Featurizer version 2 takes its equity inputs from the EHS of one hand strength pass
+// instead of a separate probabilityOfWinning run, and appends E[HS^2] and the variance of
+// HS; nets trained on version 1 features do not load into these layers and must be retrained.
+constexpr int kFeaturizerVersion = 2;
+constexpr int kInputDims = 34; // Increased for richer features
 constexpr int kNumActions = 5; // Fold, Check/Call, 1/2 pot, pot, all-in
 
-// Policy network: 32 -> 256 -> 128 -> 64 -> 5
+// Policy network: kInputDims -> 256 -> 128 -> 64 -> 5
 using policy_net = dlib::loss_multiclass_log<
     dlib::fc<kNumActions,
              dlib::relu<dlib::fc<128,
@@ -19,7 +23,7 @@ using policy_net = dlib::loss_multiclass_log<
                                                      dlib::relu<dlib::fc<512,
                                                                          dlib::input<dlib::matrix<float>>>>>>>>>>;
 
-// Value network: 32 -> 128 -> 64 -> 1
+// Value network: kInputDims -> 128 -> 64 -> 1
 using value_net = dlib::loss_mean_squared<
     dlib::fc<1,
              dlib::relu<dlib::fc<64,
@@ -0,0 +1,29 @@
+#ifndef __POKER_POLICY_STRATEGY_HPP__
+#define __POKER_POLICY_STRATEGY_HPP__
+#include <BS_thread_pool.hpp>
+#include "dlib_policy.hpp"
+#include "rl_featurizer.hpp"
+#include "rl_actions.hpp"
+#include "../simulation_farm.hpp"
+
+// Farm seat played by a trained policy net. Each copy owns its own net, since dlib runs
+// forward passes in place. featurize's equity estimate needs a pool of its own: the farm's
+// workers would deadlock waiting on tasks queued behind themselves.
+struct PolicyStrategy
+{
+    policy_net net;
+    BS::thread_pool<BS::tp::none> *featurePool = nullptr;
+    Blinds blinds{};
+    // Sample from the policy at this temperature; 0 plays the most likely action.
+    float temperature = 0.0f;
+
+    inline ActionStruct act(const Game &game, std::size_t seat, omp::XoroShiro128Plus &rng)
+    {
+        const std::vector<unsigned> legal = legal_actions(game, seat, blinds);
+        const dlib::matrix<float> state = featurize(game, seat, blinds, *featurePool);
+        const unsigned action = temperature > 0.0f ? policy_sample(net, state, legal, rng, temperature) : policy_greedy(net, state, legal);
+        return to_engine_action(action, game, seat, blinds);
+    }
+};
+static_assert(Strategy<PolicyStrategy>);
+#endif // __POKER_POLICY_STRATEGY_HPP__
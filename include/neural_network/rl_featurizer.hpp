@@ -6,9 +6,10 @@
 #include <BS_thread_pool.hpp>
 #include "../game/game.hpp"
 #include "../game.hpp"
+#include "../hand_strength.hpp"
 
-// Enhanced featurizer with 32 features for better learning
-// Uses thread pool for parallel equity calculation
+// Enhanced featurizer with kInputDims features for better learning
+// Uses thread pool for one parallel hand strength pass that supplies every equity input
 inline dlib::matrix<float> featurize(const Game &g, std::size_t heroIdx, const Blinds &blinds, BS::thread_pool<BS::tp::none> &pool)
 {
     const auto bb = std::max<std::uint32_t>(1, blinds.bigBlind);
@@ -58,9 +59,11 @@ inline dlib::matrix<float> featurize(const Game &g, std::size_t heroIdx, const B
     default: break;
     }
 
-    // Equity calculation - multithreaded for better performance
-    constexpr int equity_sims = 5000;
-    float equity = static_cast<float>(probabilityOfWinning(hero.hole, g.board(), equity_sims, ps.size() - 1, pool));
+    // Hand strength distribution - one parallel pass gives both EHS and E[HS^2]
+    // (exact on turn and river, sampled runouts on earlier streets); EHS is the equity input
+    constexpr std::size_t strength_runouts = 48;
+    auto strength = handStrengthDistribution(hero.hole, g.board(), ps.size() - 1, strength_runouts, pool);
+    float equity = static_cast<float>(strength.ehs);
 
     // Betting indicators
     float facing_bet = (to_call > 0) ? 1.f : 0.f;
@@ -71,7 +74,7 @@ inline dlib::matrix<float> featurize(const Game &g, std::size_t heroIdx, const B
     // Position indicator (rough approximation)
     float position = static_cast<float>(heroIdx) / static_cast<float>(std::max<size_t>(1, ps.size() - 1));
 
-    // Build feature vector (32 features)
+    // Build feature vector (34 features)
     dlib::matrix<float> x(kInputDims, 1);
     x = 0;
     int k = 0;
@@ -120,7 +123,11 @@ inline dlib::matrix<float> featurize(const Game &g, std::size_t heroIdx, const B
     x(k++) = (equity < 0.3f && facing_bet > 0.5f) ? 1.f : 0.f;            // should fold indicator
     x(k++) = (equity > 0.7f && can_raise > 0.5f) ? 1.f : 0.f;             // should raise indicator
 
-    // Ensure we have exactly kInputDims (32)
+    // Hand strength distribution (2 features, featurizer version 2)
+    x(k++) = static_cast<float>(strength.ehs2);                            // E[HS^2] (strong and drawing hands)
+    x(k++) = static_cast<float>(std::max(0.0, strength.ehs2 - strength.ehs * strength.ehs)); // HS variance (draws)
+
+    // Ensure we have exactly kInputDims (34)
     while (k < kInputDims)
         x(k++) = 0.f;
 
@@ -0,0 +1,386 @@
+#ifndef __POKER_PINNED_EXECUTOR_HPP__
+#define __POKER_PINNED_EXECUTOR_HPP__
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <immintrin.h>
+#include "game.hpp"
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#elif defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#endif
+
+enum class WorkerPlacement
+{
+    // Round-robin over NUMA nodes, so memory bandwidth and L3 are shared evenly.
+    Spread,
+    // Fill one node before moving to the next, so workers share a cache.
+    Compact,
+};
+
+struct PinnedExecutorOptions
+{
+    bool pin = true;
+    WorkerPlacement placement = WorkerPlacement::Spread;
+    // Pause iterations a worker spins on the job counter before it sleeps on it; ~1 ms on
+    // current x86 cores.
+    std::size_t spinIterations = 1 << 14;
+};
+
+namespace detail
+{
+    // Parses a kernel cpulist such as "0-3,8,10-11".
+    inline std::vector<int> parseCpuList(std::string_view list)
+    {
+        std::vector<int> cpus;
+        while (!list.empty())
+        {
+            const std::size_t comma = list.find(',');
+            std::string_view item = list.substr(0, comma);
+            list = comma == std::string_view::npos ? std::string_view{} : list.substr(comma + 1);
+            int first = 0;
+            auto [ptr, err] = std::from_chars(item.data(), item.data() + item.size(), first);
+            if (err != std::errc())
+            {
+                continue;
+            }
+            int last = first;
+            if (ptr != item.data() + item.size() && *ptr == '-')
+            {
+                std::from_chars(ptr + 1, item.data() + item.size(), last);
+            }
+            for (int cpu = first; cpu <= last; ++cpu)
+            {
+                cpus.push_back(cpu);
+            }
+        }
+        return cpus;
+    }
+    // CPUs of every NUMA node this process may run on. Without NUMA information all allowed
+    // CPUs form a single node.
+    inline std::vector<std::vector<int>> numaNodeCpus()
+    {
+        std::vector<int> allowed;
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        {
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+            {
+                if (CPU_ISSET(cpu, &set))
+                {
+                    allowed.push_back(cpu);
+                }
+            }
+        }
+#endif
+        if (allowed.empty())
+        {
+            for (int cpu = 0; cpu < static_cast<int>(std::thread::hardware_concurrency()); ++cpu)
+            {
+                allowed.push_back(cpu);
+            }
+        }
+        std::vector<std::vector<int>> nodes;
+#ifdef __linux__
+        for (int node = 0;; ++node)
+        {
+            std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            std::string list;
+            if (!file || !std::getline(file, list))
+            {
+                break;
+            }
+            std::vector<int> cpus;
+            for (int cpu : parseCpuList(list))
+            {
+                if (std::find(allowed.begin(), allowed.end(), cpu) != allowed.end())
+                {
+                    cpus.push_back(cpu);
+                }
+            }
+            if (!cpus.empty())
+            {
+                nodes.push_back(std::move(cpus));
+            }
+        }
+#endif
+        if (nodes.empty())
+        {
+            nodes.push_back(std::move(allowed));
+        }
+        return nodes;
+    }
+    // CPU for each of count workers; wraps around when there are more workers than CPUs.
+    inline std::vector<int> placeWorkers(std::size_t count, WorkerPlacement placement, const std::vector<std::vector<int>> &nodes)
+    {
+        std::vector<int> order;
+        if (placement == WorkerPlacement::Compact)
+        {
+            for (const auto &node : nodes)
+            {
+                order.insert(order.end(), node.begin(), node.end());
+            }
+        }
+        else
+        {
+            std::size_t widest = 0;
+            for (const auto &node : nodes)
+            {
+                widest = std::max(widest, node.size());
+            }
+            for (std::size_t i = 0; i < widest; ++i)
+            {
+                for (const auto &node : nodes)
+                {
+                    if (i < node.size())
+                    {
+                        order.push_back(node[i]);
+                    }
+                }
+            }
+        }
+        std::vector<int> cpus(count);
+        for (std::size_t i = 0; i < count && !order.empty(); ++i)
+        {
+            cpus[i] = order[i % order.size()];
+        }
+        return cpus;
+    }
+    // Affinity a thread had before pinCurrentThread, so it can be put back.
+    struct ThreadAffinity
+    {
+#ifdef __linux__
+        cpu_set_t set;
+#elif defined(_WIN32)
+        DWORD_PTR mask = 0;
+#endif
+        bool saved = false;
+    };
+    inline bool pinCurrentThread(int cpu, ThreadAffinity *previous = nullptr) noexcept
+    {
+#ifdef __linux__
+        if (previous)
+        {
+            CPU_ZERO(&previous->set);
+            previous->saved = pthread_getaffinity_np(pthread_self(), sizeof(previous->set), &previous->set) == 0;
+        }
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#elif defined(_WIN32)
+        if (cpu >= 64)
+        {
+            return false;
+        }
+        const DWORD_PTR old = SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR{1} << cpu);
+        if (previous)
+        {
+            previous->mask = old;
+            previous->saved = old != 0;
+        }
+        return old != 0;
+#else
+        (void)cpu;
+        (void)previous;
+        return false;
+#endif
+    }
+    inline void restoreCurrentThread(const ThreadAffinity &previous) noexcept
+    {
+        if (!previous.saved)
+        {
+            return;
+        }
+#ifdef __linux__
+        pthread_setaffinity_np(pthread_self(), sizeof(previous.set), &previous.set);
+#elif defined(_WIN32)
+        SetThreadAffinityMask(GetCurrentThread(), previous.mask);
+#endif
+    }
+}
+
+// Fixed set of workers, optionally pinned one per core, that run one job at a time together
+// with the calling thread. When pinning, the thread inside run takes the first CPU for that
+// job only and has its own affinity back when run returns. Dispatch is a single atomic
+// generation bump: idle workers spin on it for options.spinIterations before sleeping in
+// atomic::wait, so back-to-back small jobs start within a cache-line transfer instead of a
+// condition-variable wakeup.
+class PinnedExecutor
+{
+private:
+    std::vector<std::jthread> m_workers;
+    alignas(64) std::atomic<std::uint64_t> m_generation{0};
+    alignas(64) std::atomic<std::size_t> m_running{0};
+    void (*m_invoke)(void *, std::size_t) = nullptr;
+    void *m_context = nullptr;
+    bool m_stopping = false;
+    std::size_t m_spinIterations;
+    std::mutex m_submit;
+    int m_callerCpu = -1;
+
+    inline void workerLoop(std::size_t participant)
+    {
+        std::uint64_t seen = 0;
+        while (true)
+        {
+            std::uint64_t generation = m_generation.load(std::memory_order_acquire);
+            for (std::size_t i = 0; generation == seen && i < m_spinIterations; ++i)
+            {
+                _mm_pause();
+                generation = m_generation.load(std::memory_order_acquire);
+            }
+            if (generation == seen)
+            {
+                m_generation.wait(seen, std::memory_order_acquire);
+                continue;
+            }
+            seen = generation;
+            if (m_stopping)
+            {
+                return;
+            }
+            m_invoke(m_context, participant);
+            m_running.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+public:
+    explicit inline PinnedExecutor(std::size_t numWorkers, PinnedExecutorOptions options = {})
+        : m_spinIterations(options.spinIterations)
+    {
+        std::vector<int> cpus;
+        if (options.pin)
+        {
+            // Participant 0 runs on the caller, so the caller takes the first slot and the
+            // workers the CPUs after it.
+            cpus = detail::placeWorkers(numWorkers + 1, options.placement, detail::numaNodeCpus());
+            m_callerCpu = cpus[0];
+        }
+        m_workers.reserve(numWorkers);
+        for (std::size_t i = 0; i < numWorkers; ++i)
+        {
+            const int cpu = options.pin ? cpus[i + 1] : -1;
+            m_workers.emplace_back([this, i, cpu]
+                                   {
+                if (cpu >= 0)
+                {
+                    detail::pinCurrentThread(cpu);
+                }
+                workerLoop(i + 1); });
+        }
+    }
+    PinnedExecutor(const PinnedExecutor &) = delete;
+    PinnedExecutor &operator=(const PinnedExecutor &) = delete;
+    inline ~PinnedExecutor()
+    {
+        m_stopping = true;
+        m_generation.fetch_add(1, std::memory_order_release);
+        m_generation.notify_all();
+        m_workers.clear();
+    }
+
+    inline std::size_t threadCount() const noexcept { return m_workers.size(); }
+
+    // Calls fn(participant) once for every participant in [0, threadCount()], participant 0
+    // on the calling thread, and returns when all calls have finished. Concurrent callers
+    // are serialized. With pinning the caller runs on its reserved CPU until run returns.
+    template <typename TFunction>
+    inline void run(TFunction &&fn)
+    {
+        std::lock_guard lock(m_submit);
+        detail::ThreadAffinity callerAffinity;
+        if (m_callerCpu >= 0)
+        {
+            detail::pinCurrentThread(m_callerCpu, &callerAffinity);
+        }
+        m_invoke = [](void *context, std::size_t participant)
+        { (*static_cast<std::remove_reference_t<TFunction> *>(context))(participant); };
+        m_context = const_cast<void *>(static_cast<const void *>(&fn));
+        m_running.store(m_workers.size(), std::memory_order_relaxed);
+        m_generation.fetch_add(1, std::memory_order_release);
+        m_generation.notify_all();
+        fn(std::size_t{0});
+        // Yield once the spin budget is gone, in case a worker shares this core.
+        for (std::size_t i = 0; m_running.load(std::memory_order_acquire) != 0; ++i)
+        {
+            if (i < m_spinIterations)
+            {
+                _mm_pause();
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+        detail::restoreCurrentThread(callerAffinity);
+    }
+};
+
+// Same contract as the thread-pool runChunked: the chunk layout and per-chunk seeds only
+// depend on total and chunkSize, so seeded results match the pool version exactly.
+template <typename TResult, typename TChunkFn>
+inline TResult runChunked(PinnedExecutor &executor, std::size_t total, std::size_t chunkSize, std::uint64_t seed, std::stop_token stopToken, TChunkFn &&chunkFn)
+{
+    ChunkScheduler scheduler(total, chunkSize);
+    std::vector<TResult> partials(executor.threadCount() + 1);
+    executor.run([&](std::size_t participant)
+                 {
+        TResult &local = partials[participant];
+        ChunkRange chunk;
+        while (!stopToken.stop_requested() && scheduler.claim(chunk))
+        {
+            omp::XoroShiro128Plus rng(chunkSeed(seed, chunk.index));
+            chunkFn(local, rng, chunk);
+        } });
+    TResult result = std::move(partials[0]);
+    for (std::size_t i = 1; i < partials.size(); ++i)
+    {
+        result += partials[i];
+    }
+    return result;
+}
+template <typename TResult, typename TChunkFn>
+inline TResult runChunked(PinnedExecutor &executor, std::size_t total, std::uint64_t seed, std::stop_token stopToken, TChunkFn &&chunkFn)
+{
+    const std::size_t chunkSize = ChunkScheduler::chunkSizeFor(total, ChunkScheduler::seededWorkers);
+    return runChunked<TResult>(executor, total, chunkSize, seed, stopToken, std::forward<TChunkFn>(chunkFn));
+}
+
+inline EquityResult simulateWins(const Deck playerCards, const Deck tableCards, std::size_t numSimulations, std::size_t numPlayers, PinnedExecutor &executor, std::uint64_t seed, std::stop_token stopToken = {})
+{
+    if (!supportedTableSize(numPlayers))
+    {
+        return {};
+    }
+    Deck deck = Deck::createFullDeck();
+    deck.removeCards(playerCards);
+    deck.removeCards(tableCards);
+    return runChunked<EquityResult>(executor, numSimulations, seed, stopToken, [&](EquityResult &result, omp::XoroShiro128Plus &rng, const ChunkRange &chunk)
+                                    {
+        for (std::size_t j = 0; j < chunk.size(); ++j)
+        {
+            result.add(playRandomGame(rng, playerCards, tableCards, deck, numPlayers));
+        } });
+}
+inline double probabilityOfWinning(const Deck playerCards, const Deck tableCards, std::size_t numSimulations, std::size_t numPlayers, PinnedExecutor &executor, std::stop_token stopToken = {})
+{
+    return simulateWins(playerCards, tableCards, numSimulations, numPlayers, executor, randomSeed(), stopToken).equity();
+}
+#endif // __POKER_PINNED_EXECUTOR_HPP__
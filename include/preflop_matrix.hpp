@@ -0,0 +1,285 @@
+#ifndef __POKER_PREFLOP_MATRIX_HPP__
+#define __POKER_PREFLOP_MATRIX_HPP__
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <ostream>
+#include <utility>
+#include <vector>
+#include "hand_strength.hpp"
+#include "mapped_file.hpp"
+#include "starting_hands.hpp"
+
+inline constexpr std::size_t preflopMatrixCells = startingHandClassCount * startingHandClassCount;
+
+namespace detail
+{
+    // Maps each suit's 13-bit block of a Deck mask to the block perm[suit].
+    inline constexpr std::uint64_t permuteSuits(std::uint64_t mask, const std::array<int, 4> &perm) noexcept
+    {
+        std::uint64_t result = 0;
+        for (int suit = 0; suit < 4; ++suit)
+        {
+            result |= ((mask >> (13 * suit)) & 0x1FFFull) << (13 * perm[suit]);
+        }
+        return result;
+    }
+    struct WeightedBoard
+    {
+        std::uint64_t mask;
+        std::uint32_t weight;
+    };
+    // One representative per suit-isomorphism class of 5-card boards (the smallest mask of the
+    // orbit), weighted by the orbit size. The weights sum to C(52, 5).
+    inline std::vector<WeightedBoard> canonicalBoards()
+    {
+        std::vector<std::array<int, 4>> perms;
+        std::array<int, 4> perm = {0, 1, 2, 3};
+        do
+        {
+            perms.push_back(perm);
+        } while (std::next_permutation(perm.begin(), perm.end()));
+
+        std::vector<WeightedBoard> boards;
+        for (const Deck board : Deck::createFullDeck().subsets(5))
+        {
+            const std::uint64_t mask = board.getMask();
+            bool isCanonical = true;
+            std::uint32_t stabilizer = 0;
+            for (const auto &p : perms)
+            {
+                const std::uint64_t image = permuteSuits(mask, p);
+                if (image < mask)
+                {
+                    isCanonical = false;
+                    break;
+                }
+                stabilizer += image == mask;
+            }
+            if (isCanonical)
+            {
+                boards.push_back({mask, static_cast<std::uint32_t>(perms.size()) / stabilizer});
+            }
+        }
+        return boards;
+    }
+    // Half-point tallies: cell (hero, villain) collects 2 per win and 1 per tie over every
+    // disjoint (hero combo, villain combo, board) triple seen so far.
+    struct PreflopPoints
+    {
+        std::vector<std::uint64_t> points;
+        inline PreflopPoints &operator+=(const PreflopPoints &other)
+        {
+            if (points.empty())
+            {
+                points = other.points;
+                return *this;
+            }
+            for (std::size_t i = 0; i < other.points.size(); ++i)
+            {
+                points[i] += other.points[i];
+            }
+            return *this;
+        }
+    };
+    struct PreflopScratch
+    {
+        std::array<std::pair<ClassificationResult, std::uint16_t>, comboCount> ranked;
+        // half[B] = 2 * (class-B combos below the current group) + (class-B combos in it),
+        // halfByCard[c][B] the same restricted to combos holding card c.
+        std::array<std::uint32_t, startingHandClassCount> half;
+        std::array<std::array<std::uint32_t, startingHandClassCount>, 52> halfByCard;
+    };
+    // Adds one board's contribution, scaled by weight, to every class pair. The board's live
+    // combos are ranked and swept in strength order; for hero {x, y} of class A the villain
+    // score against class B is half[B] - halfByCard[x][B] - halfByCard[y][B], plus one on the
+    // A column because hero's own combo was subtracted twice.
+    inline void accumulatePreflopBoard(std::uint64_t boardMask, std::uint64_t weight, PreflopPoints &acc, PreflopScratch &scratch)
+    {
+        if (acc.points.empty())
+        {
+            acc.points.assign(preflopMatrixCells, 0);
+        }
+        std::size_t live = 0;
+        for (std::size_t i = 0; i < comboCount; ++i)
+        {
+            if (!(comboMasks[i] & boardMask))
+            {
+                scratch.ranked[live++] = {Hand::classify(Deck::fromMask(boardMask | comboMasks[i])), static_cast<std::uint16_t>(i)};
+            }
+        }
+        std::sort(scratch.ranked.begin(), scratch.ranked.begin() + live, [](const auto &lhs, const auto &rhs)
+                  { return lhs.first < rhs.first; });
+        scratch.half.fill(0);
+        for (auto &row : scratch.halfByCard)
+        {
+            row.fill(0);
+        }
+        auto addCombo = [&](std::size_t combo)
+        {
+            const std::size_t cls = comboClasses[combo];
+            ++scratch.half[cls];
+            ++scratch.halfByCard[comboCards[combo][0]][cls];
+            ++scratch.halfByCard[comboCards[combo][1]][cls];
+        };
+        std::array<std::uint32_t, startingHandClassCount> score;
+        for (std::size_t begin = 0; begin < live;)
+        {
+            std::size_t end = begin;
+            while (end < live && scratch.ranked[end].first == scratch.ranked[begin].first)
+            {
+                addCombo(scratch.ranked[end++].second);
+            }
+            for (std::size_t j = begin; j < end; ++j)
+            {
+                const std::size_t combo = scratch.ranked[j].second;
+                const auto &first = scratch.halfByCard[comboCards[combo][0]];
+                const auto &second = scratch.halfByCard[comboCards[combo][1]];
+                for (std::size_t b = 0; b < startingHandClassCount; ++b)
+                {
+                    score[b] = scratch.half[b] - first[b] - second[b];
+                }
+                ++score[comboClasses[combo]];
+                std::uint64_t *row = acc.points.data() + comboClasses[combo] * startingHandClassCount;
+                for (std::size_t b = 0; b < startingHandClassCount; ++b)
+                {
+                    row[b] += weight * score[b];
+                }
+            }
+            for (std::size_t j = begin; j < end; ++j)
+            {
+                addCombo(scratch.ranked[j].second);
+            }
+            begin = end;
+        }
+    }
+    // Disjoint (hero combo, villain combo) pairs for every class pair.
+    inline std::vector<std::uint64_t> preflopMatchups()
+    {
+        std::vector<std::uint64_t> matchups(preflopMatrixCells, 0);
+        for (std::size_t a = 0; a < startingHandClassCount; ++a)
+        {
+            for (std::size_t b = 0; b < startingHandClassCount; ++b)
+            {
+                for (std::size_t i = 0; i < startingHandCombos[a].count; ++i)
+                {
+                    for (std::size_t j = 0; j < startingHandCombos[b].count; ++j)
+                    {
+                        matchups[a * startingHandClassCount + b] += !(startingHandCombos[a].masks[i] & startingHandCombos[b].masks[j]);
+                    }
+                }
+            }
+        }
+        return matchups;
+    }
+    // Every disjoint combo pair sees C(48, 5) boards, two half-points each.
+    inline std::vector<double> preflopEquity(const std::vector<std::uint64_t> &points)
+    {
+        const std::vector<std::uint64_t> matchups = preflopMatchups();
+        const double boardsPerPair = static_cast<double>(Deck::binomial(48, 5));
+        std::vector<double> equity(preflopMatrixCells, 0.0);
+        for (std::size_t i = 0; i < preflopMatrixCells && i < points.size(); ++i)
+        {
+            equity[i] = static_cast<double>(points[i]) / (2.0 * boardsPerPair * static_cast<double>(matchups[i]));
+        }
+        return equity;
+    }
+    inline constexpr std::uint64_t fnv1a64(std::span<const std::byte> bytes) noexcept
+    {
+        std::uint64_t hash = 0xCBF29CE484222325ull;
+        for (std::byte b : bytes)
+        {
+            hash ^= static_cast<std::uint64_t>(b);
+            hash *= 0x100000001B3ull;
+        }
+        return hash;
+    }
+}
+
+// Exact heads-up all-in equity of every starting-hand class against every other, ties
+// counted as half. Element [hero * 169 + villain] uses StartingHandClass::index() for both.
+//
+// Class-level results do not change under a permutation of suits, so only one board per
+// suit-isomorphism class is evaluated (134,459 of the 2,598,960) and weighted by its orbit.
+// Each of those boards is a river range sweep over all live combos at once, chunked across
+// the pool.
+inline std::vector<double> computePreflopMatrix(BS::thread_pool<BS::tp::none> &threadPool)
+{
+    const std::vector<detail::WeightedBoard> boards = detail::canonicalBoards();
+    const std::size_t chunkSize = std::max<std::size_t>(1, boards.size() / ((threadPool.get_thread_count() + 1) * 64));
+    detail::PreflopPoints total = runChunked<detail::PreflopPoints>(threadPool, boards.size(), chunkSize, 0, {}, [&](detail::PreflopPoints &acc, omp::XoroShiro128Plus &, const ChunkRange &chunk)
+                                                                     {
+        auto scratch = std::make_unique<detail::PreflopScratch>();
+        for (std::size_t i = chunk.begin; i < chunk.end; ++i)
+        {
+            detail::accumulatePreflopBoard(boards[i].mask, boards[i].weight, acc, *scratch);
+        } });
+
+    return detail::preflopEquity(total.points);
+}
+
+// On-disk layout: this header, then 169 * 169 row-major float64 equities in host byte order.
+struct PreflopMatrixHeader
+{
+    std::array<char, 8> magic = {'P', 'F', 'M', 'A', 'T', 'R', 'I', 'X'};
+    std::uint32_t version = 1;
+    std::uint32_t classCount = static_cast<std::uint32_t>(startingHandClassCount);
+    // FNV-1a of the equity payload.
+    std::uint64_t checksum = 0;
+};
+static_assert(sizeof(PreflopMatrixHeader) == 24 && std::is_trivially_copyable_v<PreflopMatrixHeader>);
+
+inline void writePreflopMatrix(std::ostream &os, const std::vector<double> &equity)
+{
+    PreflopMatrixHeader header;
+    header.checksum = detail::fnv1a64(std::as_bytes(std::span(equity)));
+    os.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    os.write(reinterpret_cast<const char *>(equity.data()), static_cast<std::streamsize>(equity.size() * sizeof(double)));
+}
+
+// Memory-mapped view of a matrix written by writePreflopMatrix.
+class PreflopMatrix
+{
+private:
+    MappedFile m_file;
+    const double *m_equity = nullptr;
+
+public:
+    // Returns std::nullopt when the file is missing, truncated, from another version or fails
+    // its checksum.
+    static inline std::optional<PreflopMatrix> load(const char *path)
+    {
+        std::optional<MappedFile> file = MappedFile::open(path);
+        if (!file || file->size() != sizeof(PreflopMatrixHeader) + preflopMatrixCells * sizeof(double))
+        {
+            return std::nullopt;
+        }
+        PreflopMatrixHeader header;
+        std::memcpy(&header, file->bytes().data(), sizeof(header));
+        if (header.magic != PreflopMatrixHeader{}.magic || header.version != 1 || header.classCount != startingHandClassCount)
+        {
+            return std::nullopt;
+        }
+        const std::span<const std::byte> payload = file->bytes().subspan(sizeof(header));
+        if (detail::fnv1a64(payload) != header.checksum)
+        {
+            return std::nullopt;
+        }
+        PreflopMatrix matrix;
+        matrix.m_equity = reinterpret_cast<const double *>(payload.data());
+        matrix.m_file = std::move(*file);
+        return matrix;
+    }
+    inline double equity(StartingHandClass hero, StartingHandClass villain) const noexcept
+    {
+        return m_equity[hero.index() * startingHandClassCount + villain.index()];
+    }
+    inline std::span<const double, preflopMatrixCells> values() const noexcept
+    {
+        return std::span<const double, preflopMatrixCells>(m_equity, preflopMatrixCells);
+    }
+};
+#endif // __POKER_PREFLOP_MATRIX_HPP__
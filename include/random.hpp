@@ -5,6 +5,12 @@
 #include <climits>
 #include <bit>
 #include <array>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 namespace omp
 {
     static inline constexpr std::uint64_t splitmix64(std::uint64_t &x)
@@ -102,6 +108,190 @@ namespace omp
         std::uint32_t mUsesLeft{};
         param_type mParams{};
     };
+    // xoshiro256+ with four independent lanes, stepped together in one AVX2 register. Each
+    // block of four outputs costs a handful of vector instructions and carries no dependency
+    // on the outputs of the previous block, so throughput is bounded by the vector ports
+    // rather than by the state update latency of a single 64-bit generator.
+    //
+    // operator() hands out buffered values one at a time, so it satisfies the same TRng
+    // contract as XoroShiro128Plus (Deck::popPair, popRandomCards, FastUniformIntDistribution).
+    // fill() and fillBounded() write whole blocks directly. Without AVX2 (or in constant
+    // evaluation) the lanes are stepped with scalar code and produce the same sequence.
+    class XoShiro256PlusX4
+    {
+    public:
+        typedef std::uint64_t result_type;
+        static constexpr std::size_t lanes = 4;
+
+        constexpr explicit XoShiro256PlusX4(std::uint64_t seed) { this->seed(seed); }
+
+        // Lane states come from one splitmix64 stream, lane by lane.
+        inline constexpr void seed(std::uint64_t s)
+        {
+            for (std::size_t lane = 0; lane < lanes; ++lane)
+            {
+                for (std::size_t word = 0; word < 4; ++word)
+                {
+                    mState[word * lanes + lane] = splitmix64(s);
+                }
+            }
+            mIndex = bufferSize;
+        }
+
+        constexpr inline std::uint64_t operator()()
+        {
+            if (mIndex == bufferSize)
+            {
+                for (std::size_t i = 0; i < bufferSize; i += lanes)
+                {
+                    next(mBuffer.data() + i);
+                }
+                mIndex = 0;
+            }
+            return mBuffer[mIndex++];
+        }
+
+        // Writes out.size() values; whole blocks bypass the buffer. Interleaves the lanes the
+        // same way operator() does, but does not consume values already buffered there.
+        constexpr inline void fill(std::span<std::uint64_t> out)
+        {
+            std::size_t i = 0;
+#ifdef __AVX2__
+            if (!std::is_constant_evaluated())
+            {
+                VectorState v = load();
+                for (; i + lanes <= out.size(); i += lanes)
+                {
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out.data() + i), step(v));
+                }
+                store(v);
+            }
+#endif
+            for (; i + lanes <= out.size(); i += lanes)
+            {
+                next(out.data() + i);
+            }
+            if (i < out.size())
+            {
+                std::uint64_t block[lanes];
+                next(block);
+                for (std::size_t j = 0; i < out.size(); ++i, ++j)
+                {
+                    out[i] = block[j];
+                }
+            }
+        }
+
+        // Uniform indices in [0, bound): both 32-bit halves of every output, multiply-shift
+        // as in Deck::popPair, eight indices per block.
+        inline void fillBounded(std::span<std::uint32_t> out, std::uint32_t bound)
+        {
+            std::size_t i = 0;
+#ifdef __AVX2__
+            const __m256i scale = _mm256_set1_epi64x(bound);
+            const __m256i highDwords = _mm256_set1_epi64x(static_cast<long long>(0xFFFFFFFF00000000ull));
+            VectorState v = load();
+            for (; i + 2 * lanes <= out.size(); i += 2 * lanes)
+            {
+                const __m256i r = step(v);
+                const __m256i lo = _mm256_srli_epi64(_mm256_mul_epu32(r, scale), 32);
+                const __m256i hi = _mm256_and_si256(_mm256_mul_epu32(_mm256_srli_epi64(r, 32), scale), highDwords);
+                // lo holds lane indices in the low dword of each qword and hi in the high
+                // dword, so OR-ing interleaves them as (lane 0 low, lane 0 high, lane 1 low...).
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out.data() + i), _mm256_or_si256(lo, hi));
+            }
+            store(v);
+#endif
+            for (; i < out.size(); i += 2 * lanes)
+            {
+                std::uint64_t block[lanes];
+                next(block);
+                for (std::size_t j = 0; j < 2 * lanes && i + j < out.size(); ++j)
+                {
+                    const std::uint64_t half = (j & 1) ? block[j >> 1] >> 32 : block[j >> 1] & 0xFFFFFFFFull;
+                    out[i + j] = static_cast<std::uint32_t>((half * bound) >> 32);
+                }
+            }
+        }
+
+        static constexpr inline std::uint64_t min()
+        {
+            return 0;
+        }
+
+        static constexpr inline std::uint64_t max()
+        {
+            return ~(uint64_t)0;
+        }
+
+    private:
+        static constexpr std::size_t bufferSize = 4 * lanes;
+        // mState[word * lanes + lane]: word-major, so each state word is one vector.
+        alignas(32) std::array<std::uint64_t, 4 * lanes> mState{};
+        alignas(32) std::array<std::uint64_t, bufferSize> mBuffer{};
+        std::size_t mIndex = bufferSize;
+
+        constexpr inline void next(std::uint64_t *out)
+        {
+#ifdef __AVX2__
+            if (!std::is_constant_evaluated())
+            {
+                VectorState v = load();
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), step(v));
+                store(v);
+                return;
+            }
+#endif
+            for (std::size_t lane = 0; lane < lanes; ++lane)
+            {
+                std::uint64_t &s0 = mState[0 * lanes + lane];
+                std::uint64_t &s1 = mState[1 * lanes + lane];
+                std::uint64_t &s2 = mState[2 * lanes + lane];
+                std::uint64_t &s3 = mState[3 * lanes + lane];
+                out[lane] = s0 + s3;
+                const std::uint64_t t = s1 << 17;
+                s2 ^= s0;
+                s3 ^= s1;
+                s1 ^= s2;
+                s0 ^= s3;
+                s2 ^= t;
+                s3 = std::rotl(s3, 45);
+            }
+        }
+#ifdef __AVX2__
+        struct VectorState
+        {
+            __m256i s0, s1, s2, s3;
+        };
+        inline VectorState load() const noexcept
+        {
+            return {_mm256_load_si256(reinterpret_cast<const __m256i *>(mState.data() + 0 * lanes)),
+                    _mm256_load_si256(reinterpret_cast<const __m256i *>(mState.data() + 1 * lanes)),
+                    _mm256_load_si256(reinterpret_cast<const __m256i *>(mState.data() + 2 * lanes)),
+                    _mm256_load_si256(reinterpret_cast<const __m256i *>(mState.data() + 3 * lanes))};
+        }
+        inline void store(const VectorState &v) noexcept
+        {
+            _mm256_store_si256(reinterpret_cast<__m256i *>(mState.data() + 0 * lanes), v.s0);
+            _mm256_store_si256(reinterpret_cast<__m256i *>(mState.data() + 1 * lanes), v.s1);
+            _mm256_store_si256(reinterpret_cast<__m256i *>(mState.data() + 2 * lanes), v.s2);
+            _mm256_store_si256(reinterpret_cast<__m256i *>(mState.data() + 3 * lanes), v.s3);
+        }
+        // Advances every lane of v once and returns the four outputs.
+        static inline __m256i step(VectorState &v) noexcept
+        {
+            const __m256i result = _mm256_add_epi64(v.s0, v.s3);
+            const __m256i t = _mm256_slli_epi64(v.s1, 17);
+            v.s2 = _mm256_xor_si256(v.s2, v.s0);
+            v.s3 = _mm256_xor_si256(v.s3, v.s1);
+            v.s1 = _mm256_xor_si256(v.s1, v.s2);
+            v.s0 = _mm256_xor_si256(v.s0, v.s3);
+            v.s2 = _mm256_xor_si256(v.s2, t);
+            v.s3 = _mm256_or_si256(_mm256_slli_epi64(v.s3, 45), _mm256_srli_epi64(v.s3, 19));
+            return result;
+        }
+#endif
+    };
 }
 
-#endif // OMP_RANDOM_H
\ No newline at end of file
+#endif // OMP_RANDOM_H
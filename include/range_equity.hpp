@@ -0,0 +1,89 @@
+#ifndef __POKER_RANGE_EQUITY_HPP__
+#define __POKER_RANGE_EQUITY_HPP__
+#include <algorithm>
+#include <array>
+#include <span>
+#include <utility>
+#include "hand.hpp"
+#include "hand_range.hpp"
+#include "starting_hands.hpp"
+
+// Equity of every hero combo against a weighted villain range on a complete board, both in
+// canonical combo order (see comboIndex). Ties split the pot. Hero combos that use a board
+// card, or that leave no villain weight after card removal, get 0.
+//
+// All combos are ranked once and sorted by strength. A sweep over the strength groups keeps
+// the villain weight strictly below the current group, both in total and per card. A hero
+// holding {a, b} then beats the weight below, minus the part that holds a or b, and ties the
+// rest of its own group the same way. The only combo holding both a and b is hero's own, so
+// adding its weight back once corrects the double subtraction. The whole vector costs
+// O(n log n) instead of an O(n^2) matchup table.
+inline std::array<float, comboCount> riverRangeEquity(const Deck board, const std::span<const float, comboCount> villainWeights)
+{
+    std::array<float, comboCount> equity{};
+    const std::uint64_t boardMask = board.getMask();
+    std::array<std::pair<ClassificationResult, std::uint16_t>, comboCount> ranked;
+    std::size_t live = 0;
+    double totalWeight = 0.0;
+    std::array<double, 52> cardWeight{};
+    for (std::size_t i = 0; i < comboCount; ++i)
+    {
+        const std::uint64_t mask = comboMasks[i];
+        if (mask & boardMask)
+        {
+            continue;
+        }
+        ranked[live++] = {Hand::classify(Deck::fromMask(boardMask | mask)), static_cast<std::uint16_t>(i)};
+        const double weight = villainWeights[i];
+        totalWeight += weight;
+        cardWeight[comboCards[i][0]] += weight;
+        cardWeight[comboCards[i][1]] += weight;
+    }
+    std::sort(ranked.begin(), ranked.begin() + live, [](const auto &lhs, const auto &rhs)
+              { return lhs.first < rhs.first; });
+
+    double belowWeight = 0.0;
+    std::array<double, 52> belowCard{};
+    std::array<double, 52> groupCard{};
+    for (std::size_t begin = 0; begin < live;)
+    {
+        std::size_t end = begin;
+        double groupWeight = 0.0;
+        while (end < live && ranked[end].first == ranked[begin].first)
+        {
+            const std::size_t combo = ranked[end].second;
+            const double weight = villainWeights[combo];
+            groupWeight += weight;
+            groupCard[comboCards[combo][0]] += weight;
+            groupCard[comboCards[combo][1]] += weight;
+            ++end;
+        }
+        for (std::size_t j = begin; j < end; ++j)
+        {
+            const std::size_t combo = ranked[j].second;
+            const std::size_t a = comboCards[combo][0];
+            const std::size_t b = comboCards[combo][1];
+            const double own = villainWeights[combo];
+            const double wins = belowWeight - belowCard[a] - belowCard[b];
+            const double ties = groupWeight - groupCard[a] - groupCard[b] + own;
+            const double total = totalWeight - cardWeight[a] - cardWeight[b] + own;
+            equity[combo] = total > 0.0 ? static_cast<float>((wins + 0.5 * ties) / total) : 0.0f;
+        }
+        belowWeight += groupWeight;
+        for (std::size_t j = begin; j < end; ++j)
+        {
+            for (std::size_t card : comboCards[ranked[j].second])
+            {
+                belowCard[card] += groupCard[card];
+                groupCard[card] = 0.0;
+            }
+        }
+        begin = end;
+    }
+    return equity;
+}
+inline std::array<float, comboCount> riverRangeEquity(const Deck board, const HandRange &villainRange)
+{
+    return riverRangeEquity(board, villainRange.weights());
+}
+#endif // __POKER_RANGE_EQUITY_HPP__
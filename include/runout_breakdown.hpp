@@ -0,0 +1,173 @@
+#ifndef __POKER_RUNOUT_BREAKDOWN_HPP__
+#define __POKER_RUNOUT_BREAKDOWN_HPP__
+#include <array>
+#include <bit>
+#include "game.hpp"
+
+// Hero's equity conditioned on each possible next board card. Entries are indexed by the
+// card's bit position in a Deck mask; only the bits set in nextCards are meaningful. A k-way
+// split counts 1/k of the pot, as in simulateWins.
+struct RunoutBreakdown
+{
+    std::array<double, 52> equity{};
+    std::array<std::size_t, 52> trials{};
+    std::uint64_t nextCards = 0;
+    // Every unseen card is equally likely to come next, so the unconditional equity is the
+    // plain mean of the per-card equities.
+    double average = 0.0;
+    bool exact = false;
+    inline constexpr double equityFor(const Card card) const noexcept
+    {
+        return equity[static_cast<std::size_t>(std::countr_zero(Deck::createDeck({card}).getMask()))];
+    }
+};
+
+namespace detail
+{
+    struct RunoutCounts
+    {
+        std::array<EquityResult, 52> results{};
+        inline constexpr RunoutCounts &operator+=(const RunoutCounts &other) noexcept
+        {
+            for (std::size_t i = 0; i < 52; ++i)
+            {
+                results[i] += other.results[i];
+            }
+            return *this;
+        }
+    };
+    // Players splitting the pot with hero, hero included, as returned by playRandomGame.
+    inline std::size_t heroSharing(ClassificationResult heroResult, const Deck tableCards, const std::span<const Deck> opponents) noexcept
+    {
+        std::size_t sharing = 1;
+        for (const Deck opponent : opponents)
+        {
+            const ClassificationResult oppResult = Hand::classify(Deck::createDeck({opponent, tableCards}));
+            if (oppResult > heroResult)
+            {
+                return 0;
+            }
+            sharing += oppResult == heroResult;
+        }
+        return sharing;
+    }
+}
+
+// Breaks hero's flop or turn equity down by the next card in one parallel run. Every trial
+// deals the opponents (and, from the flop, the river) once and then evaluates that same deal
+// under every next card it does not block, so all buckets share their random opponents and
+// the differences between buckets carry far less noise than independent runs would. When
+// the sampled river is itself the next card being evaluated, a spare card dealt with the
+// trial stands in for it. Heads-up on the turn the breakdown is enumerated exactly.
+inline RunoutBreakdown runoutBreakdown(const Deck playerCards, const Deck tableCards, std::size_t numSimulations, std::size_t numPlayers, BS::thread_pool<BS::tp::none> &threadPool, std::uint64_t seed = randomSeed())
+{
+    RunoutBreakdown result;
+    if (tableCards.size() < 3 || tableCards.size() > 4 || !supportedTableSize(numPlayers))
+    {
+        return result;
+    }
+    Deck deck = Deck::createFullDeck();
+    deck.removeCards(playerCards);
+    deck.removeCards(tableCards);
+    result.nextCards = deck.getMask();
+    const bool onTurn = tableCards.size() == 4;
+    const std::size_t numOpponents = numPlayers - 1;
+
+    detail::RunoutCounts counts;
+    if (onTurn && numPlayers == 2)
+    {
+        result.exact = true;
+        const std::uint64_t boardMask = tableCards.getMask();
+        const std::uint64_t heroMask = boardMask | playerCards.getMask();
+        counts = runChunked<detail::RunoutCounts>(threadPool, 52, 1, seed, {}, [&](detail::RunoutCounts &acc, omp::XoroShiro128Plus &, const ChunkRange &chunk)
+                                                  {
+            for (std::size_t river = chunk.begin; river < chunk.end; ++river)
+            {
+                const std::uint64_t riverBit = 1ull << river;
+                if (!(result.nextCards & riverBit))
+                {
+                    continue;
+                }
+                const ClassificationResult heroResult = Hand::classify(Deck::fromMask(heroMask | riverBit));
+                const std::uint64_t unseen = result.nextCards & ~riverBit;
+                for (std::uint64_t first = unseen; first; first &= first - 1)
+                {
+                    const std::uint64_t firstBit = first & -static_cast<std::int64_t>(first);
+                    for (std::uint64_t second = first & (first - 1); second; second &= second - 1)
+                    {
+                        const std::uint64_t secondBit = second & -static_cast<std::int64_t>(second);
+                        const ClassificationResult oppResult = Hand::classify(Deck::fromMask(boardMask | riverBit | firstBit | secondBit));
+                        acc.results[river].add(oppResult > heroResult ? 0 : (oppResult == heroResult ? 2 : 1));
+                    }
+                }
+            } });
+    }
+    else
+    {
+        // From the turn hero's final hand only depends on the river, so classify it once per card.
+        std::array<ClassificationResult, 52> heroOnRiver{};
+        for (std::uint64_t m = onTurn ? result.nextCards : 0; m; m &= m - 1)
+        {
+            const std::size_t card = static_cast<std::size_t>(std::countr_zero(m));
+            heroOnRiver[card] = Hand::classify(Deck::fromMask(playerCards.getMask() | tableCards.getMask() | (1ull << card)));
+        }
+        counts = runChunked<detail::RunoutCounts>(threadPool, numSimulations, seed, {}, [&](detail::RunoutCounts &acc, omp::XoroShiro128Plus &rng, const ChunkRange &chunk)
+                                                  {
+            std::array<Deck, 9> opponents;
+            for (std::size_t t = 0; t < chunk.size(); ++t)
+            {
+                Deck trialDeck = deck;
+                std::uint64_t dealt = 0;
+                for (std::size_t i = 0; i < numOpponents; ++i)
+                {
+                    opponents[i] = trialDeck.popPair(rng);
+                    dealt |= opponents[i].getMask();
+                }
+                const std::span<const Deck> seated(opponents.data(), numOpponents);
+                std::uint64_t riverBit = 0;
+                std::uint64_t spareBit = 0;
+                if (!onTurn)
+                {
+                    riverBit = trialDeck.popRandomCards(rng, 1).getMask();
+                    spareBit = trialDeck.popRandomCards(rng, 1).getMask();
+                }
+                for (std::uint64_t m = result.nextCards & ~dealt; m; m &= m - 1)
+                {
+                    const std::size_t card = static_cast<std::size_t>(std::countr_zero(m));
+                    const std::uint64_t cardBit = 1ull << card;
+                    Deck board = Deck::fromMask(tableCards.getMask() | cardBit);
+                    ClassificationResult heroResult;
+                    if (onTurn)
+                    {
+                        heroResult = heroOnRiver[card];
+                    }
+                    else
+                    {
+                        board.addCards(Deck::fromMask(cardBit == riverBit ? spareBit : riverBit));
+                        heroResult = Hand::classify(Deck::createDeck({playerCards, board}));
+                    }
+                    acc.results[card].add(detail::heroSharing(heroResult, board, seated));
+                }
+            } });
+    }
+
+    std::size_t buckets = 0;
+    for (std::uint64_t m = result.nextCards; m; m &= m - 1)
+    {
+        const std::size_t card = static_cast<std::size_t>(std::countr_zero(m));
+        result.trials[card] = counts.results[card].trials();
+        if (result.trials[card] == 0)
+        {
+            continue;
+        }
+        result.equity[card] = counts.results[card].equity();
+        result.average += result.equity[card];
+        ++buckets;
+    }
+    if (buckets)
+    {
+        result.average /= static_cast<double>(buckets);
+    }
+    return result;
+}
+#endif // __POKER_RUNOUT_BREAKDOWN_HPP__
@@ -0,0 +1,322 @@
+#ifndef __POKER_SHARDED_EQUITY_HPP__
+#define __POKER_SHARDED_EQUITY_HPP__
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "game.hpp"
+#include "preflop_matrix.hpp"
+#include "socket.hpp"
+#include "starting_hand_equity.hpp"
+
+enum class ShardJobKind : std::uint32_t
+{
+    // simulateWins: EquityResult {wins, ties, losses, potShare, potShareSquares}.
+    Equity = 1,
+    // simulateStartingHands: an EquityResult per class (5 values each, class-major), deals.
+    StartingHands = 2,
+    // Exact preflop matrix over canonical boards: 169 * 169 half-point tallies.
+    PreflopMatrix = 3,
+};
+
+// A job is split into numShards() shards of shardSize work items (trials, deals or
+// canonical boards). Shard i always runs with chunkSeed(seed, i), so its counts are the same
+// on every worker and a shard lost with its worker can simply be handed out again. Results
+// are integer counts, so merging shards in any order is exact.
+struct ShardJob
+{
+    ShardJobKind kind = ShardJobKind::Equity;
+    std::uint32_t numPlayers = 2;
+    std::uint64_t playerMask = 0;
+    std::uint64_t tableMask = 0;
+    std::uint64_t total = 0;
+    std::uint64_t shardSize = 1;
+    std::uint64_t seed = 0;
+
+    // False for jobs a worker must not run: an unknown kind, empty shards, or a table size the
+    // engines do not support (see EquityResult::maxPlayers). Jobs arrive over the wire, so
+    // both ends check.
+    inline constexpr bool valid() const noexcept
+    {
+        return resultSize() != 0 && shardSize != 0 && supportedTableSize(numPlayers);
+    }
+    inline constexpr std::uint64_t numShards() const noexcept { return total / shardSize + (total % shardSize != 0); }
+    inline constexpr std::uint64_t shardBegin(std::uint64_t shard) const noexcept { return shard * shardSize; }
+    inline constexpr std::uint64_t shardEnd(std::uint64_t shard) const noexcept { return std::min(total, (shard + 1) * shardSize); }
+    inline constexpr std::size_t resultSize() const noexcept
+    {
+        switch (kind)
+        {
+        case ShardJobKind::Equity:
+            return 5;
+        case ShardJobKind::StartingHands:
+            return 5 * startingHandClassCount + 1;
+        case ShardJobKind::PreflopMatrix:
+            return preflopMatrixCells;
+        }
+        return 0;
+    }
+};
+static_assert(std::is_trivially_copyable_v<ShardJob> && sizeof(ShardJob) == 48);
+
+namespace detail
+{
+    inline const std::vector<WeightedBoard> &sharedCanonicalBoards()
+    {
+        static const std::vector<WeightedBoard> boards = canonicalBoards();
+        return boards;
+    }
+
+    enum class ShardMessageType : std::uint32_t
+    {
+        Assign = 1,
+        Result = 2,
+        Done = 3,
+    };
+    // Every message starts with this header. Assign is followed by the ShardJob, Result by
+    // job.resultSize() uint64 counts. All fields travel in host byte order, so coordinator
+    // and workers must share endianness.
+    struct ShardMessageHeader
+    {
+        static constexpr std::uint32_t expectedMagic = 0x48534B50; // "PKSH"
+        static constexpr std::uint32_t expectedVersion = 3;
+        std::uint32_t magic = expectedMagic;
+        std::uint32_t version = expectedVersion;
+        ShardMessageType type = ShardMessageType::Done;
+        std::uint32_t reserved = 0;
+        std::uint64_t shard = 0;
+        inline constexpr bool valid() const noexcept { return magic == expectedMagic && version == expectedVersion; }
+    };
+    static_assert(std::is_trivially_copyable_v<ShardMessageHeader> && sizeof(ShardMessageHeader) == 24);
+
+    template <typename T>
+    inline bool sendValue(const Socket &socket, const T &value)
+    {
+        return socket.sendAll(std::as_bytes(std::span(&value, 1)));
+    }
+    template <typename T>
+    inline bool receiveValue(const Socket &socket, T &value)
+    {
+        return socket.receiveAll(std::as_writable_bytes(std::span(&value, 1)));
+    }
+    template <typename T>
+    inline bool receiveValue(const Socket &socket, T &value, std::chrono::steady_clock::time_point deadline, std::stop_token stopToken = {})
+    {
+        return socket.receiveAll(std::as_writable_bytes(std::span(&value, 1)), deadline, stopToken);
+    }
+}
+
+// Time a worker gets to return a shard before the coordinator gives up on it. Generous,
+// since the largest shards (a block of canonical boards) take minutes on a slow machine.
+inline constexpr std::chrono::milliseconds defaultShardTimeout = std::chrono::minutes(30);
+
+inline std::vector<std::uint64_t> computeShard(const ShardJob &job, std::uint64_t shard, BS::thread_pool<BS::tp::none> &threadPool)
+{
+    const std::uint64_t begin = job.shardBegin(shard);
+    const std::uint64_t end = job.shardEnd(shard);
+    const std::uint64_t seed = chunkSeed(job.seed, shard);
+    const Deck playerCards = Deck::fromMask(job.playerMask);
+    const Deck tableCards = Deck::fromMask(job.tableMask);
+    std::vector<std::uint64_t> result(job.resultSize(), 0);
+    switch (job.kind)
+    {
+    case ShardJobKind::Equity:
+    {
+        EquityResult counts = simulateWins(playerCards, tableCards, end - begin, job.numPlayers, threadPool, seed);
+        result = {counts.wins, counts.ties, counts.losses, counts.potShare, counts.potShareSquares};
+        break;
+    }
+    case ShardJobKind::StartingHands:
+    {
+        StartingHandCounts counts = simulateStartingHands(tableCards, end - begin, job.numPlayers, threadPool, seed);
+        for (std::size_t c = 0; c < startingHandClassCount; ++c)
+        {
+            const EquityResult &r = counts.results[c];
+            const std::array<std::uint64_t, 5> values = {r.wins, r.ties, r.losses, r.potShare, r.potShareSquares};
+            std::copy(values.begin(), values.end(), result.begin() + 5 * c);
+        }
+        result.back() = counts.deals;
+        break;
+    }
+    case ShardJobKind::PreflopMatrix:
+    {
+        const auto &boards = detail::sharedCanonicalBoards();
+        const std::uint64_t last = std::min<std::uint64_t>(end, boards.size());
+        const std::size_t count = begin < last ? last - begin : 0;
+        detail::PreflopPoints points = runChunked<detail::PreflopPoints>(threadPool, count, 16, seed, {}, [&](detail::PreflopPoints &acc, omp::XoroShiro128Plus &, const ChunkRange &chunk)
+                                                                          {
+            auto scratch = std::make_unique<detail::PreflopScratch>();
+            for (std::size_t i = chunk.begin; i < chunk.end; ++i)
+            {
+                detail::accumulatePreflopBoard(boards[begin + i].mask, boards[begin + i].weight, acc, *scratch);
+            } });
+        if (!points.points.empty())
+        {
+            result = std::move(points.points);
+        }
+        break;
+    }
+    }
+    return result;
+}
+
+// Reference result computed in this process, shard by shard.
+inline std::vector<std::uint64_t> computeAllShards(const ShardJob &job, BS::thread_pool<BS::tp::none> &threadPool)
+{
+    std::vector<std::uint64_t> totals(job.resultSize(), 0);
+    for (std::uint64_t shard = 0; shard < job.numShards(); ++shard)
+    {
+        std::vector<std::uint64_t> counts = computeShard(job, shard, threadPool);
+        for (std::size_t i = 0; i < totals.size(); ++i)
+        {
+            totals[i] += counts[i];
+        }
+    }
+    return totals;
+}
+
+// Hands out the shards of job to every worker that connects to listener and returns the
+// merged counts once all shards are in. Each connection is served by its own thread; when a
+// worker disconnects, or holds a shard longer than shardTimeout, the connection is dropped
+// and the shard goes back to the queue. Returns an empty vector if stopToken fires first or
+// the job is not valid().
+inline std::vector<std::uint64_t> coordinateShards(const ShardJob &job, const Socket &listener, std::chrono::milliseconds shardTimeout = defaultShardTimeout, std::stop_token stopToken = {})
+{
+    if (!job.valid())
+    {
+        return {};
+    }
+    struct State
+    {
+        std::mutex mutex;
+        std::condition_variable_any changed;
+        std::deque<std::uint64_t> pending;
+        std::vector<bool> finished;
+        std::uint64_t remaining = 0;
+        std::vector<std::uint64_t> totals;
+    } state;
+    for (std::uint64_t shard = 0; shard < job.numShards(); ++shard)
+    {
+        state.pending.push_back(shard);
+    }
+    state.finished.assign(job.numShards(), false);
+    state.remaining = job.numShards();
+    state.totals.assign(job.resultSize(), 0);
+
+    auto serve = [&job, &state, shardTimeout, stopToken](Socket worker)
+    {
+        std::vector<std::uint64_t> counts(job.resultSize());
+        while (true)
+        {
+            std::uint64_t shard = 0;
+            {
+                std::unique_lock lock(state.mutex);
+                if (!state.changed.wait(lock, stopToken, [&]
+                                        { return !state.pending.empty() || state.remaining == 0; }))
+                {
+                    return;
+                }
+                if (state.remaining == 0)
+                {
+                    break;
+                }
+                shard = state.pending.front();
+                state.pending.pop_front();
+            }
+            detail::ShardMessageHeader header;
+            header.type = detail::ShardMessageType::Assign;
+            header.shard = shard;
+            detail::ShardMessageHeader reply;
+            const auto deadline = std::chrono::steady_clock::now() + shardTimeout;
+            const bool delivered = detail::sendValue(worker, header) && detail::sendValue(worker, job) &&
+                                   detail::receiveValue(worker, reply, deadline, stopToken) && reply.valid() &&
+                                   reply.type == detail::ShardMessageType::Result && reply.shard == shard &&
+                                   worker.receiveAll(std::as_writable_bytes(std::span(counts)), deadline, stopToken);
+            std::lock_guard lock(state.mutex);
+            if (!delivered)
+            {
+                state.pending.push_back(shard);
+                state.changed.notify_all();
+                return;
+            }
+            if (!state.finished[shard])
+            {
+                state.finished[shard] = true;
+                --state.remaining;
+                for (std::size_t i = 0; i < counts.size(); ++i)
+                {
+                    state.totals[i] += counts[i];
+                }
+                state.changed.notify_all();
+            }
+        }
+        detail::ShardMessageHeader done;
+        done.type = detail::ShardMessageType::Done;
+        detail::sendValue(worker, done);
+    };
+
+    std::vector<std::jthread> connections;
+    while (!stopToken.stop_requested())
+    {
+        {
+            std::lock_guard lock(state.mutex);
+            if (state.remaining == 0)
+            {
+                break;
+            }
+        }
+        if (!listener.waitReadable(100))
+        {
+            continue;
+        }
+        if (std::optional<Socket> worker = listener.accept())
+        {
+            connections.emplace_back(serve, std::move(*worker));
+        }
+    }
+    connections.clear();
+    if (state.remaining != 0)
+    {
+        return {};
+    }
+    return state.totals;
+}
+
+// Pulls shards from a coordinator until it reports the job done, the connection drops, it
+// sends a job that is not valid(), or stopToken fires. Returns the number of shards this
+// worker completed.
+inline std::size_t runShardWorker(const std::string &host, std::uint16_t port, BS::thread_pool<BS::tp::none> &threadPool, std::stop_token stopToken = {})
+{
+    std::optional<Socket> coordinator = Socket::connect(host, port);
+    if (!coordinator)
+    {
+        return 0;
+    }
+    constexpr auto noDeadline = std::chrono::steady_clock::time_point::max();
+    std::size_t completed = 0;
+    detail::ShardMessageHeader header;
+    while (detail::receiveValue(*coordinator, header, noDeadline, stopToken) && header.valid() && header.type == detail::ShardMessageType::Assign)
+    {
+        ShardJob job;
+        if (!detail::receiveValue(*coordinator, job, noDeadline, stopToken) || !job.valid())
+        {
+            break;
+        }
+        std::vector<std::uint64_t> counts = computeShard(job, header.shard, threadPool);
+        detail::ShardMessageHeader reply;
+        reply.type = detail::ShardMessageType::Result;
+        reply.shard = header.shard;
+        if (!detail::sendValue(*coordinator, reply) || !coordinator->sendAll(std::as_bytes(std::span(counts))))
+        {
+            break;
+        }
+        ++completed;
+    }
+    return completed;
+}
+#endif // __POKER_SHARDED_EQUITY_HPP__
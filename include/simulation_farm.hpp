@@ -0,0 +1,271 @@
+#ifndef __POKER_SIMULATION_FARM_HPP__
+#define __POKER_SIMULATION_FARM_HPP__
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <memory>
+#include <span>
+#include <stop_token>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "chunk_scheduler.hpp"
+#include "game.hpp"
+#include "game/game.hpp"
+
+// A bot: picks the action for the player in seat when it is that seat's turn. act may keep
+// state; the farm gives every table its own copy, so strategies never share state across
+// threads.
+template <typename TStrategy>
+concept Strategy = std::copy_constructible<TStrategy> &&
+                   requires(TStrategy &strategy, const Game &game, std::size_t seat, omp::XoroShiro128Plus &rng) {
+                       { strategy.act(game, seat, rng) } -> std::same_as<ActionStruct>;
+                   };
+
+// Checks when it can and calls everything else.
+struct CallStationStrategy
+{
+    inline ActionStruct act(const Game &game, std::size_t seat, omp::XoroShiro128Plus &) const noexcept
+    {
+        const Player &player = game.players()[seat];
+        return game.betData().currentBet > player.committed ? ActionStruct{ActionType::Call, 0} : ActionStruct{ActionType::Check, 0};
+    }
+};
+
+// Estimates its pot-share equity against the players still in the hand with a short Monte
+// Carlo run, then raises the pot above raiseThreshold, calls when the equity beats both
+// callThreshold and the pot odds, and otherwise checks or folds.
+struct EquityThresholdStrategy
+{
+    double callThreshold = 0.4;
+    double raiseThreshold = 0.7;
+    std::size_t simulations = 200;
+
+    inline ActionStruct act(const Game &game, std::size_t seat, omp::XoroShiro128Plus &rng) const
+    {
+        const Player &player = game.players()[seat];
+        const BetData &bet = game.betData();
+        const double equity = probabilityOfWinning(rng, player.hole, game.board(), simulations, std::max<std::size_t>(2, game.aliveSeats().size()));
+        const std::uint32_t toCall = bet.currentBet > player.committed ? bet.currentBet - player.committed : 0;
+        if (equity >= raiseThreshold)
+        {
+            const std::uint32_t size = std::max(bet.minRaise, bet.pot);
+            return bet.currentBet == 0 ? ActionStruct{ActionType::Bet, size} : ActionStruct{ActionType::Raise, bet.currentBet + size};
+        }
+        if (toCall == 0)
+        {
+            return {ActionType::Check, 0};
+        }
+        const double potOdds = static_cast<double>(toCall) / static_cast<double>(bet.pot + toCall);
+        if (equity >= std::max(callThreshold, potOdds))
+        {
+            return {ActionType::Call, 0};
+        }
+        return {ActionType::Fold, 0};
+    }
+};
+
+// Type-erased Strategy, for line-ups chosen at runtime. Copying clones the strategy.
+class AnyStrategy
+{
+private:
+    struct Concept
+    {
+        virtual ~Concept() = default;
+        virtual ActionStruct act(const Game &game, std::size_t seat, omp::XoroShiro128Plus &rng) = 0;
+        virtual std::unique_ptr<Concept> clone() const = 0;
+    };
+    template <Strategy TStrategy>
+    struct Model final : Concept
+    {
+        TStrategy strategy;
+        explicit Model(TStrategy s) : strategy(std::move(s)) {}
+        ActionStruct act(const Game &game, std::size_t seat, omp::XoroShiro128Plus &rng) override { return strategy.act(game, seat, rng); }
+        std::unique_ptr<Concept> clone() const override { return std::make_unique<Model>(strategy); }
+    };
+    std::unique_ptr<Concept> m_strategy;
+
+public:
+    template <Strategy TStrategy>
+        requires(!std::same_as<std::remove_cvref_t<TStrategy>, AnyStrategy>)
+    AnyStrategy(TStrategy strategy) : m_strategy(std::make_unique<Model<TStrategy>>(std::move(strategy))) {}
+    AnyStrategy(const AnyStrategy &other) : m_strategy(other.m_strategy->clone()) {}
+    AnyStrategy(AnyStrategy &&) noexcept = default;
+    AnyStrategy &operator=(const AnyStrategy &other)
+    {
+        m_strategy = other.m_strategy->clone();
+        return *this;
+    }
+    AnyStrategy &operator=(AnyStrategy &&) noexcept = default;
+
+    inline ActionStruct act(const Game &game, std::size_t seat, omp::XoroShiro128Plus &rng) { return m_strategy->act(game, seat, rng); }
+};
+
+struct FarmOptions
+{
+    std::size_t tables = 1024;
+    std::size_t handsPerTable = 1000;
+    // Every stack is reset to this before each hand, so each hand is an independent sample.
+    std::uint32_t startingChips = 10000;
+    Blinds blinds{};
+    // Table t plays with omp::XoroShiro128Plus(chunkSeed(seed, t)), whatever the pool size.
+    std::uint64_t seed = 0;
+    // Shift every strategy one seat left after each hand, so position averages out.
+    bool rotateSeats = true;
+};
+
+// Totals of one strategy over every hand it played.
+struct StrategyResult
+{
+    std::uint64_t hands = 0;
+    std::uint64_t handsWon = 0;
+    std::int64_t netChips = 0;
+    double netChipsSquares = 0.0;
+
+    inline constexpr StrategyResult &operator+=(const StrategyResult &other) noexcept
+    {
+        hands += other.hands;
+        handsWon += other.handsWon;
+        netChips += other.netChips;
+        netChipsSquares += other.netChipsSquares;
+        return *this;
+    }
+    // Win rate in big blinds per 100 hands, and its standard error.
+    inline constexpr double bigBlindsPer100(std::uint32_t bigBlind) const noexcept
+    {
+        return hands ? 100.0 * static_cast<double>(netChips) / (static_cast<double>(hands) * bigBlind) : 0.0;
+    }
+    inline double bigBlindsPer100Error(std::uint32_t bigBlind) const noexcept
+    {
+        if (hands < 2)
+        {
+            return 0.0;
+        }
+        const double n = static_cast<double>(hands);
+        const double mean = static_cast<double>(netChips) / n;
+        const double variance = std::max(0.0, (netChipsSquares - n * mean * mean) / (n - 1.0));
+        return 100.0 * std::sqrt(variance / n) / bigBlind;
+    }
+};
+
+// Per-strategy results, in the order the strategies were given. Workers fill their own and
+// merge them once at the end.
+struct FarmResult
+{
+    std::vector<StrategyResult> strategies;
+    std::uint64_t hands = 0;
+
+    inline FarmResult &operator+=(const FarmResult &other)
+    {
+        strategies.resize(std::max(strategies.size(), other.strategies.size()));
+        for (std::size_t i = 0; i < other.strategies.size(); ++i)
+        {
+            strategies[i] += other.strategies[i];
+        }
+        hands += other.hands;
+        return *this;
+    }
+};
+
+namespace detail
+{
+    // Line-up known at compile time: act dispatches to the index-th strategy without a
+    // virtual call.
+    template <Strategy... TStrategies>
+    struct StrategyTuple
+    {
+        std::tuple<TStrategies...> strategies;
+        static constexpr std::size_t size() noexcept { return sizeof...(TStrategies); }
+        inline ActionStruct act(std::size_t index, const Game &game, std::size_t seat, omp::XoroShiro128Plus &rng)
+        {
+            ActionStruct action{ActionType::Fold, 0};
+            std::size_t i = 0;
+            std::apply([&](auto &...strategy)
+                       { ((i++ == index ? (action = strategy.act(game, seat, rng), true) : false) || ...); }, strategies);
+            return action;
+        }
+    };
+    struct StrategyList
+    {
+        std::vector<AnyStrategy> strategies;
+        inline std::size_t size() const noexcept { return strategies.size(); }
+        inline ActionStruct act(std::size_t index, const Game &game, std::size_t seat, omp::XoroShiro128Plus &rng)
+        {
+            return strategies[index].act(game, seat, rng);
+        }
+    };
+
+    // Plays options.handsPerTable hands at one table and adds them to result.
+    template <typename TLineup>
+    inline void playFarmTable(TLineup &lineup, const FarmOptions &options, omp::XoroShiro128Plus &rng, FarmResult &result)
+    {
+        const std::size_t numSeats = lineup.size();
+        Game game(options.blinds);
+        for (std::size_t i = 0; i < numSeats; ++i)
+        {
+            game.addPlayer(options.startingChips);
+        }
+        std::array<std::size_t, Game::maxSeats> strategyAt{};
+        for (std::size_t hand = 0; hand < options.handsPerTable; ++hand)
+        {
+            const std::size_t shift = options.rotateSeats ? hand % numSeats : 0;
+            for (std::size_t seat = 0; seat < numSeats; ++seat)
+            {
+                strategyAt[seat] = (seat + shift) % numSeats;
+            }
+            game.resetPlayerChips(options.startingChips);
+            game.startNewHand(rng);
+            while (game.state() != GameState::Finished)
+            {
+                if (!game.hasCurrentActor())
+                {
+                    game.applyAction(rng, ActionStruct{ActionType::Check, 0});
+                    continue;
+                }
+                const std::size_t seat = game.currentPlayer().id;
+                game.applyAction(rng, lineup.act(strategyAt[seat], game, seat, rng));
+            }
+            for (std::size_t seat = 0; seat < numSeats; ++seat)
+            {
+                StrategyResult &totals = result.strategies[strategyAt[seat]];
+                const std::int64_t net = static_cast<std::int64_t>(game.players()[seat].chips) - options.startingChips;
+                ++totals.hands;
+                totals.handsWon += net > 0;
+                totals.netChips += net;
+                totals.netChipsSquares += static_cast<double>(net) * static_cast<double>(net);
+            }
+        }
+        result.hands += options.handsPerTable;
+    }
+
+    template <typename TLineup>
+    inline FarmResult runFarm(const TLineup &lineup, const FarmOptions &options, BS::thread_pool<BS::tp::none> &threadPool, std::stop_token stopToken)
+    {
+        if (lineup.size() < 2 || lineup.size() > Game::maxSeats)
+        {
+            return {};
+        }
+        // One table per chunk, so each table's rng is chunkSeed(seed, table): a table is
+        // thousands of hands, far more work than claiming a chunk costs.
+        FarmResult result = runChunked<FarmResult>(threadPool, options.tables, 1, options.seed, stopToken, [&](FarmResult &local, omp::XoroShiro128Plus &rng, const ChunkRange &)
+                                                   {
+            local.strategies.resize(lineup.size());
+            TLineup tableLineup = lineup;
+            playFarmTable(tableLineup, options, rng, local); });
+        result.strategies.resize(lineup.size());
+        return result;
+    }
+}
+
+// Plays options.tables independent tables of options.handsPerTable hands each on the pool,
+// one seat per strategy (2 to 10 of them). Results come back per strategy, in argument order.
+template <Strategy... TStrategies>
+inline FarmResult runSimulationFarm(const FarmOptions &options, BS::thread_pool<BS::tp::none> &threadPool, std::stop_token stopToken, TStrategies... strategies)
+{
+    return detail::runFarm(detail::StrategyTuple<TStrategies...>{{std::move(strategies)...}}, options, threadPool, stopToken);
+}
+inline FarmResult runSimulationFarm(const FarmOptions &options, BS::thread_pool<BS::tp::none> &threadPool, std::span<const AnyStrategy> strategies, std::stop_token stopToken = {})
+{
+    return detail::runFarm(detail::StrategyList{{strategies.begin(), strategies.end()}}, options, threadPool, stopToken);
+}
+#endif // __POKER_SIMULATION_FARM_HPP__
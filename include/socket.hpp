@@ -0,0 +1,250 @@
+#ifndef __POKER_SOCKET_HPP__
+#define __POKER_SOCKET_HPP__
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <utility>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+// Minimal blocking TCP socket over Winsock or BSD sockets. Move-only; closes on destruction.
+class Socket
+{
+public:
+#ifdef _WIN32
+    using NativeHandle = SOCKET;
+    static constexpr NativeHandle invalidHandle = INVALID_SOCKET;
+#else
+    using NativeHandle = int;
+    static constexpr NativeHandle invalidHandle = -1;
+#endif
+
+private:
+    NativeHandle m_handle = invalidHandle;
+
+    inline explicit Socket(NativeHandle handle) noexcept : m_handle(handle) {}
+    static inline bool initialize() noexcept
+    {
+#ifdef _WIN32
+        static const bool started = []()
+        {
+            WSADATA data;
+            return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+        }();
+        return started;
+#else
+        return true;
+#endif
+    }
+    static inline void closeHandle(NativeHandle handle) noexcept
+    {
+#ifdef _WIN32
+        closesocket(handle);
+#else
+        ::close(handle);
+#endif
+    }
+
+public:
+    inline Socket() noexcept = default;
+    Socket(const Socket &) = delete;
+    Socket &operator=(const Socket &) = delete;
+    inline Socket(Socket &&other) noexcept : m_handle(std::exchange(other.m_handle, invalidHandle)) {}
+    inline Socket &operator=(Socket &&other) noexcept
+    {
+        if (this != &other)
+        {
+            close();
+            m_handle = std::exchange(other.m_handle, invalidHandle);
+        }
+        return *this;
+    }
+    inline ~Socket() { close(); }
+
+    inline bool isOpen() const noexcept { return m_handle != invalidHandle; }
+    inline void close() noexcept
+    {
+        if (isOpen())
+        {
+            closeHandle(std::exchange(m_handle, invalidHandle));
+        }
+    }
+
+    // Listens on every interface; port 0 picks a free port, see localPort().
+    static inline std::optional<Socket> listen(std::uint16_t port, int backlog = 16) noexcept
+    {
+        if (!initialize())
+        {
+            return std::nullopt;
+        }
+        Socket socket(::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP));
+        if (!socket.isOpen())
+        {
+            return std::nullopt;
+        }
+        int reuse = 1;
+        setsockopt(socket.m_handle, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char *>(&reuse), sizeof(reuse));
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        address.sin_port = htons(port);
+        if (::bind(socket.m_handle, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0 || ::listen(socket.m_handle, backlog) != 0)
+        {
+            return std::nullopt;
+        }
+        return socket;
+    }
+    static inline std::optional<Socket> connect(const std::string &host, std::uint16_t port) noexcept
+    {
+        if (!initialize())
+        {
+            return std::nullopt;
+        }
+        addrinfo hints{};
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_protocol = IPPROTO_TCP;
+        addrinfo *found = nullptr;
+        const std::string service = std::to_string(port);
+        if (getaddrinfo(host.c_str(), service.c_str(), &hints, &found) != 0)
+        {
+            return std::nullopt;
+        }
+        std::optional<Socket> result;
+        for (addrinfo *candidate = found; candidate && !result; candidate = candidate->ai_next)
+        {
+            Socket socket(::socket(candidate->ai_family, candidate->ai_socktype, candidate->ai_protocol));
+            if (socket.isOpen() && ::connect(socket.m_handle, candidate->ai_addr, static_cast<socklen_t>(candidate->ai_addrlen)) == 0)
+            {
+                socket.setNoDelay();
+                result = std::move(socket);
+            }
+        }
+        freeaddrinfo(found);
+        return result;
+    }
+    inline std::optional<Socket> accept() const noexcept
+    {
+        Socket client(::accept(m_handle, nullptr, nullptr));
+        if (!client.isOpen())
+        {
+            return std::nullopt;
+        }
+        client.setNoDelay();
+        return client;
+    }
+    inline std::uint16_t localPort() const noexcept
+    {
+        sockaddr_in address{};
+        socklen_t length = sizeof(address);
+        if (getsockname(m_handle, reinterpret_cast<sockaddr *>(&address), &length) != 0)
+        {
+            return 0;
+        }
+        return ntohs(address.sin_port);
+    }
+    // True when a read (or an accept on a listening socket) would not block. Uses poll on
+    // POSIX, since FD_SET on a descriptor at or above FD_SETSIZE writes out of bounds.
+    inline bool waitReadable(int timeoutMilliseconds) const noexcept
+    {
+#ifdef _WIN32
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET(m_handle, &readable);
+        timeval timeout{timeoutMilliseconds / 1000, (timeoutMilliseconds % 1000) * 1000};
+        return ::select(0, &readable, nullptr, nullptr, &timeout) > 0;
+#else
+        pollfd descriptor{m_handle, POLLIN, 0};
+        return ::poll(&descriptor, 1, timeoutMilliseconds) > 0;
+#endif
+    }
+    inline void setNoDelay() noexcept
+    {
+        int enable = 1;
+        setsockopt(m_handle, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char *>(&enable), sizeof(enable));
+    }
+    // Both return false once the peer is gone; a partial transfer counts as a failure.
+    inline bool sendAll(std::span<const std::byte> bytes) const noexcept
+    {
+#ifdef MSG_NOSIGNAL
+        constexpr int flags = MSG_NOSIGNAL;
+#else
+        constexpr int flags = 0;
+#endif
+        while (!bytes.empty())
+        {
+            const auto sent = ::send(m_handle, reinterpret_cast<const char *>(bytes.data()), static_cast<int>(bytes.size()), flags);
+            if (sent <= 0)
+            {
+                return false;
+            }
+            bytes = bytes.subspan(static_cast<std::size_t>(sent));
+        }
+        return true;
+    }
+    inline bool receiveAll(std::span<std::byte> bytes) const noexcept
+    {
+        while (!bytes.empty())
+        {
+            const auto received = ::recv(m_handle, reinterpret_cast<char *>(bytes.data()), static_cast<int>(bytes.size()), 0);
+            if (received <= 0)
+            {
+                return false;
+            }
+            bytes = bytes.subspan(static_cast<std::size_t>(received));
+        }
+        return true;
+    }
+    // Same, but also gives up once deadline passes or stopToken fires, so a peer that stops
+    // answering without closing the connection cannot block the caller forever. The wait runs
+    // in slices of stopPollMilliseconds, which bounds how late a stop is noticed.
+    static constexpr int stopPollMilliseconds = 100;
+    inline bool receiveAll(std::span<std::byte> bytes, std::chrono::steady_clock::time_point deadline, std::stop_token stopToken = {}) const noexcept
+    {
+        while (!bytes.empty())
+        {
+            if (stopToken.stop_requested())
+            {
+                return false;
+            }
+            const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+            if (remaining <= 0)
+            {
+                return false;
+            }
+            if (!waitReadable(static_cast<int>(std::min<decltype(remaining)>(remaining, stopPollMilliseconds))))
+            {
+                continue;
+            }
+            const auto received = ::recv(m_handle, reinterpret_cast<char *>(bytes.data()), static_cast<int>(bytes.size()), 0);
+            if (received <= 0)
+            {
+                return false;
+            }
+            bytes = bytes.subspan(static_cast<std::size_t>(received));
+        }
+        return true;
+    }
+};
+#endif // __POKER_SOCKET_HPP__
@@ -0,0 +1,148 @@
+#ifndef __POKER_STARTING_HAND_EQUITY_HPP__
+#define __POKER_STARTING_HAND_EQUITY_HPP__
+#include <array>
+#include <ostream>
+#include "game.hpp"
+#include "starting_hands.hpp"
+
+// Equity of every starting-hand class on a fixed board, laid out like the 13x13 chart. A
+// k-way split counts 1/k of the pot, as in simulateWins.
+struct StartingHandEquity
+{
+    std::array<double, startingHandClassCount> equity{};
+    // Hero combos evaluated per class, after rejecting the ones blocked by each deal.
+    std::array<std::size_t, startingHandClassCount> trials{};
+    std::size_t deals = 0;
+
+    inline constexpr double at(std::size_t row, std::size_t col) const noexcept { return equity[row * 13 + col]; }
+    inline void writeCsv(std::ostream &os) const
+    {
+        constexpr std::string_view ranks = "AKQJT98765432";
+        for (char rank : ranks)
+        {
+            os << ',' << rank;
+        }
+        os << '\n';
+        for (std::size_t row = 0; row < 13; ++row)
+        {
+            os << ranks[row];
+            for (std::size_t col = 0; col < 13; ++col)
+            {
+                os << ',' << at(row, col);
+            }
+            os << '\n';
+        }
+    }
+    // "P169" followed by the 169 equities as row-major float64 in host byte order.
+    inline void writeBinary(std::ostream &os) const
+    {
+        os.write("P169", 4);
+        os.write(reinterpret_cast<const char *>(equity.data()), static_cast<std::streamsize>(equity.size() * sizeof(double)));
+    }
+};
+
+struct StartingHandCounts
+{
+    std::array<EquityResult, startingHandClassCount> results{};
+    std::size_t deals = 0;
+    inline constexpr StartingHandCounts &operator+=(const StartingHandCounts &other) noexcept
+    {
+        for (std::size_t i = 0; i < startingHandClassCount; ++i)
+        {
+            results[i] += other.results[i];
+        }
+        deals += other.deals;
+        return *this;
+    }
+};
+
+// Equity of all 169 classes against numPlayers - 1 random opponents with one shared set of
+// deals. Each trial deals the runout and the opponents once, ranks the best opponent (and
+// how many opponents share that rank) once, and then scores every hero combo that does not
+// collide with the deal. A deal drawn from the cards off the board and conditioned on
+// missing a combo is a uniform deal for that combo, so per-combo rejection keeps every
+// class unbiased while all classes see the same boards and opponents, which keeps their
+// relative ranking smooth.
+inline StartingHandCounts simulateStartingHands(const Deck tableCards, std::size_t numSimulations, std::size_t numPlayers, BS::thread_pool<BS::tp::none> &threadPool, std::uint64_t seed)
+{
+    if (tableCards.size() > 5 || !supportedTableSize(numPlayers))
+    {
+        return {};
+    }
+    Deck deck = Deck::createFullDeck();
+    deck.removeCards(tableCards);
+    const std::uint64_t boardMask = tableCards.getMask();
+    const std::size_t numCardsToDeal = 5 - tableCards.size();
+
+    // Combos that use a board card can never be dealt, drop them up front.
+    std::array<StartingHandCombos, startingHandClassCount> combos{};
+    for (std::size_t c = 0; c < startingHandClassCount; ++c)
+    {
+        for (std::size_t i = 0; i < startingHandCombos[c].count; ++i)
+        {
+            if (!(startingHandCombos[c].masks[i] & boardMask))
+            {
+                combos[c].masks[combos[c].count++] = startingHandCombos[c].masks[i];
+            }
+        }
+    }
+
+    return runChunked<StartingHandCounts>(threadPool, numSimulations, seed, {}, [&](StartingHandCounts &acc, omp::XoroShiro128Plus &rng, const ChunkRange &chunk)
+                                          {
+        for (std::size_t t = 0; t < chunk.size(); ++t)
+        {
+            Deck trialDeck = deck;
+            Deck board = tableCards;
+            if (numCardsToDeal)
+            {
+                board.addCards(trialDeck.popRandomCards(rng, numCardsToDeal));
+            }
+            std::uint64_t used = board.getMask();
+            ClassificationResult bestOpponent{};
+            std::size_t bestOpponents = 0;
+            for (std::size_t i = 0; i < numPlayers - 1; ++i)
+            {
+                Deck opp = trialDeck.popPair(rng);
+                used |= opp.getMask();
+                const ClassificationResult oppResult = Hand::classify(Deck::createDeck({opp, board}));
+                if (i == 0 || oppResult > bestOpponent)
+                {
+                    bestOpponent = oppResult;
+                    bestOpponents = 1;
+                }
+                else if (oppResult == bestOpponent)
+                {
+                    ++bestOpponents;
+                }
+            }
+            for (std::size_t c = 0; c < startingHandClassCount; ++c)
+            {
+                for (std::size_t i = 0; i < combos[c].count; ++i)
+                {
+                    if (combos[c].masks[i] & used)
+                    {
+                        continue;
+                    }
+                    const ClassificationResult heroResult = Hand::classify(Deck::fromMask(board.getMask() | combos[c].masks[i]));
+                    acc.results[c].add(bestOpponent > heroResult ? 0 : (bestOpponent == heroResult ? 1 + bestOpponents : 1));
+                }
+            }
+        }
+        acc.deals += chunk.size(); });
+}
+inline StartingHandEquity startingHandEquity(const StartingHandCounts &counts)
+{
+    StartingHandEquity result;
+    for (std::size_t c = 0; c < startingHandClassCount; ++c)
+    {
+        result.trials[c] = counts.results[c].trials();
+        result.equity[c] = counts.results[c].equity();
+    }
+    result.deals = counts.deals;
+    return result;
+}
+inline StartingHandEquity startingHandEquity(const Deck tableCards, std::size_t numSimulations, std::size_t numPlayers, BS::thread_pool<BS::tp::none> &threadPool, std::uint64_t seed = randomSeed())
+{
+    return startingHandEquity(simulateStartingHands(tableCards, numSimulations, numPlayers, threadPool, seed));
+}
+#endif // __POKER_STARTING_HAND_EQUITY_HPP__
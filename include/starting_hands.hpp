@@ -0,0 +1,121 @@
+#ifndef __POKER_STARTING_HANDS_HPP__
+#define __POKER_STARTING_HANDS_HPP__
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <string>
+#include "deck.hpp"
+
+inline constexpr std::size_t startingHandClassCount = 169;
+
+// One cell of the usual 13x13 starting-hand chart. Row and column 0 are the ace and 12 the
+// deuce; pairs sit on the diagonal, suited hands above it (row < col) and offsuit hands
+// below it.
+struct StartingHandClass
+{
+    std::uint8_t row = 0;
+    std::uint8_t col = 0;
+
+    static inline constexpr StartingHandClass fromIndex(std::size_t index) noexcept
+    {
+        return {static_cast<std::uint8_t>(index / 13), static_cast<std::uint8_t>(index % 13)};
+    }
+    // hand must hold exactly two cards.
+    static inline constexpr StartingHandClass fromHand(const Deck hand) noexcept
+    {
+        const std::uint64_t mask = hand.getMask();
+        const int first = std::countr_zero(mask);
+        const int second = 63 - std::countl_zero(mask);
+        const int high = std::max(first % 13, second % 13);
+        const int low = std::min(first % 13, second % 13);
+        if (high == low)
+        {
+            return {static_cast<std::uint8_t>(12 - high), static_cast<std::uint8_t>(12 - high)};
+        }
+        if (first / 13 == second / 13)
+        {
+            return {static_cast<std::uint8_t>(12 - high), static_cast<std::uint8_t>(12 - low)};
+        }
+        return {static_cast<std::uint8_t>(12 - low), static_cast<std::uint8_t>(12 - high)};
+    }
+    inline constexpr std::size_t index() const noexcept { return static_cast<std::size_t>(row) * 13 + col; }
+    inline constexpr bool isPair() const noexcept { return row == col; }
+    inline constexpr bool isSuited() const noexcept { return row < col; }
+    inline constexpr std::size_t comboCount() const noexcept { return isPair() ? 6 : (isSuited() ? 4 : 12); }
+    inline std::string name() const
+    {
+        constexpr std::string_view ranks = "AKQJT98765432";
+        std::string result{ranks[std::min(row, col)], ranks[std::max(row, col)]};
+        if (!isPair())
+        {
+            result += isSuited() ? 's' : 'o';
+        }
+        return result;
+    }
+    inline constexpr bool operator==(const StartingHandClass &other) const noexcept = default;
+};
+
+struct StartingHandCombos
+{
+    std::array<std::uint64_t, 12> masks{};
+    std::size_t count = 0;
+};
+
+// Two-card Deck masks of every combo in each class, indexed by StartingHandClass::index().
+inline constexpr std::array<StartingHandCombos, startingHandClassCount> startingHandCombos = []()
+{
+    std::array<StartingHandCombos, startingHandClassCount> table{};
+    for (std::uint64_t first = 0; first < 52; ++first)
+    {
+        for (std::uint64_t second = first + 1; second < 52; ++second)
+        {
+            const std::uint64_t mask = (1ull << first) | (1ull << second);
+            auto &combos = table[StartingHandClass::fromHand(Deck::fromMask(mask)).index()];
+            combos.masks[combos.count++] = mask;
+        }
+    }
+    return table;
+}();
+
+// Canonical order of the 1326 two-card combos: the colex rank of the Deck mask, i.e. for bit
+// positions lo < hi the index is hi * (hi - 1) / 2 + lo.
+inline constexpr std::size_t comboCount = 1326;
+inline constexpr std::size_t comboIndex(std::uint64_t mask) noexcept
+{
+    const std::size_t lo = static_cast<std::size_t>(std::countr_zero(mask));
+    const std::size_t hi = static_cast<std::size_t>(63 - std::countl_zero(mask));
+    return hi * (hi - 1) / 2 + lo;
+}
+inline constexpr std::array<std::uint64_t, comboCount> comboMasks = []()
+{
+    std::array<std::uint64_t, comboCount> table{};
+    for (std::uint64_t hi = 1; hi < 52; ++hi)
+    {
+        for (std::uint64_t lo = 0; lo < hi; ++lo)
+        {
+            table[hi * (hi - 1) / 2 + lo] = (1ull << lo) | (1ull << hi);
+        }
+    }
+    return table;
+}();
+// Bit positions {lo, hi} of each combo's cards.
+inline constexpr std::array<std::array<std::uint8_t, 2>, comboCount> comboCards = []()
+{
+    std::array<std::array<std::uint8_t, 2>, comboCount> table{};
+    for (std::size_t i = 0; i < comboCount; ++i)
+    {
+        table[i] = {static_cast<std::uint8_t>(std::countr_zero(comboMasks[i])), static_cast<std::uint8_t>(63 - std::countl_zero(comboMasks[i]))};
+    }
+    return table;
+}();
+// StartingHandClass::index() of each combo.
+inline constexpr std::array<std::uint8_t, comboCount> comboClasses = []()
+{
+    std::array<std::uint8_t, comboCount> table{};
+    for (std::size_t i = 0; i < comboCount; ++i)
+    {
+        table[i] = static_cast<std::uint8_t>(StartingHandClass::fromHand(Deck::fromMask(comboMasks[i])).index());
+    }
+    return table;
+}();
+#endif // __POKER_STARTING_HANDS_HPP__
@@ -1,5 +1,51 @@
 #include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+#include <thread>
+#include <vector>
 #include "../include/game.hpp"
+#include "../include/game/game.hpp"
+#include "../include/game/game_batch.hpp"
+#include "../include/game/hand_history.hpp"
+#include "../include/pinned_executor.hpp"
+#include "../include/hand_potential.hpp"
+#include "../include/runout_breakdown.hpp"
+#include "../include/starting_hand_equity.hpp"
+#include "../include/range_equity.hpp"
+#include "../include/simulation_farm.hpp"
+
+// Counts every plain operator new in this binary, so benchmarks can report allocations per
+// item; one relaxed increment per allocation leaves the other timings unaffected.
+static std::atomic<std::uint64_t> allocationCount{0};
+void *operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size == 0 ? 1 : size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+// GCC pairs the inlined free() with the new-expression at the call site and warns.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
 
 // ============================================================================
 // Deck Creation and Card Operations
@@ -85,6 +131,138 @@ static void BM_PopPairOfRandomCards(benchmark::State &state)
 
 BENCHMARK(BM_PopPairOfRandomCards);
 
+// Opponent hands plus the rest of a preflop board for st.range(0) players: the popPair loop
+// that playRandomGame runs against one dealHands call.
+static void BM_DealOpponentsPopPairLoop(benchmark::State &st)
+{
+    omp::XoroShiro128Plus rng(st.thread_index() + st.iterations());
+    const std::size_t numOpponents = st.range(0) - 1;
+    Deck start = Deck::createFullDeck();
+    start.removeCards(Deck::parseHand("as kd"));
+    for (auto _ : st)
+    {
+        Deck deck = start;
+        Deck board = deck.popRandomCards(rng, 5);
+        for (std::size_t i = 0; i < numOpponents; ++i)
+        {
+            Deck opp = deck.popPair(rng);
+            benchmark::DoNotOptimize(opp);
+        }
+        benchmark::DoNotOptimize(board);
+    }
+}
+BENCHMARK(BM_DealOpponentsPopPairLoop)->DenseRange(2, 10, 1);
+
+static void BM_DealOpponentsDealHands(benchmark::State &st)
+{
+    omp::XoroShiro128Plus rng(st.thread_index() + st.iterations());
+    const std::size_t numOpponents = st.range(0) - 1;
+    Deck start = Deck::createFullDeck();
+    start.removeCards(Deck::parseHand("as kd"));
+    for (auto _ : st)
+    {
+        Deck deck = start;
+        Deck board = Deck::emptyDeck();
+        auto hands = deck.dealHands(rng, numOpponents, board, 5);
+        benchmark::DoNotOptimize(hands);
+        benchmark::DoNotOptimize(board);
+    }
+}
+BENCHMARK(BM_DealOpponentsDealHands)->DenseRange(2, 10, 1);
+
+// 64-bit values per second: the scalar generator (0), the four-lane generator one value at a
+// time through the TRng interface (1), and its bulk fill (2).
+static void BM_RandomThroughput(benchmark::State &st)
+{
+    std::vector<std::uint64_t> values(1024);
+    omp::XoroShiro128Plus scalar(1);
+    omp::XoShiro256PlusX4 lanes(1);
+    for (auto _ : st)
+    {
+        switch (st.range(0))
+        {
+        case 0:
+            for (auto &value : values)
+            {
+                value = scalar();
+            }
+            break;
+        case 1:
+            for (auto &value : values)
+            {
+                value = lanes();
+            }
+            break;
+        default:
+            lanes.fill(values);
+            break;
+        }
+        benchmark::DoNotOptimize(values.data());
+        benchmark::ClobberMemory();
+    }
+    st.SetItemsProcessed(st.iterations() * values.size());
+}
+BENCHMARK(BM_RandomThroughput)->Arg(0)->Arg(1)->Arg(2)->ArgNames({"generator"});
+
+static void BM_DealOpponentsDealHandsX4(benchmark::State &st)
+{
+    omp::XoShiro256PlusX4 rng(st.thread_index() + st.iterations());
+    const std::size_t numOpponents = st.range(0) - 1;
+    Deck start = Deck::createFullDeck();
+    start.removeCards(Deck::parseHand("as kd"));
+    for (auto _ : st)
+    {
+        Deck deck = start;
+        Deck board = Deck::emptyDeck();
+        auto hands = deck.dealHands(rng, numOpponents, board, 5);
+        benchmark::DoNotOptimize(hands);
+        benchmark::DoNotOptimize(board);
+    }
+}
+BENCHMARK(BM_DealOpponentsDealHandsX4)->DenseRange(2, 10, 4);
+
+// Card draws with the select path forced: st.range(0) is the path (1 PDEP, 2 broadword
+// select), st.range(1) the draw (0 popPair, 1 popRandomCards(5), 2 dealHands for 9 players
+// and a board). On Zen 1 / Zen 2 path 1 is the microcoded PDEP that auto-dispatch avoids.
+static void BM_SelectPath(benchmark::State &state)
+{
+    const auto path = static_cast<SelectPath>(state.range(0));
+    if (setSelectPath(path) != path)
+    {
+        setSelectPath(SelectPath::Auto);
+        state.SkipWithError("PDEP is not available on this CPU");
+        return;
+    }
+    omp::XoroShiro128Plus rng(1);
+    std::uint64_t sink = 0;
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < 256; ++i)
+        {
+            Deck deck = Deck::createFullDeck();
+            switch (state.range(1))
+            {
+            case 0:
+                sink ^= deck.popPair(rng).getMask();
+                break;
+            case 1:
+                sink ^= deck.popRandomCards(rng, 5).getMask();
+                break;
+            default:
+            {
+                Deck board = Deck::emptyDeck();
+                sink ^= deck.dealHands(rng, 9, board, 5)[8].getMask() ^ board.getMask();
+                break;
+            }
+            }
+        }
+    }
+    benchmark::DoNotOptimize(sink);
+    state.SetItemsProcessed(state.iterations() * 256);
+    setSelectPath(SelectPath::Auto);
+}
+BENCHMARK(BM_SelectPath)->ArgsProduct({{1, 2}, {0, 1, 2}})->ArgNames({"path", "draw"});
+
 static void BM_DeckIteration(benchmark::State &state)
 {
     Deck deck = Deck::createFullDeck();
@@ -102,6 +280,28 @@ static void BM_DeckIteration(benchmark::State &state)
 }
 BENCHMARK(BM_DeckIteration);
 
+// Every 2-card runout of a flop deck (st.range(0) == 0), or one eighth of them starting
+// mid-enumeration the way a thread's share of an exact enumeration would (1).
+static void BM_SubsetIteration(benchmark::State &state)
+{
+    Deck deck = Deck::createFullDeck();
+    deck.removeCards(Deck::parseHand("As Kh Qd Jc Ts"));
+    const std::uint64_t total = Deck::binomial(deck.size(), 2);
+    const std::uint64_t first = state.range(0) ? total / 2 : 0;
+    const std::uint64_t last = state.range(0) ? first + total / 8 : total;
+    for (auto _ : state)
+    {
+        std::uint64_t sink = 0;
+        for (const Deck runout : deck.subsets(2, first, last))
+        {
+            sink ^= runout.getMask();
+        }
+        benchmark::DoNotOptimize(sink);
+    }
+    state.SetItemsProcessed(state.iterations() * (last - first));
+}
+BENCHMARK(BM_SubsetIteration)->Arg(0)->Arg(1)->ArgName("split");
+
 static void BM_ParseHand(benchmark::State &state)
 {
     for (auto _ : state)
@@ -292,7 +492,7 @@ BENCHMARK(BM_CompareHandsMultipleOpponents);
 // Game Simulation Benchmarks
 // ============================================================================
 
-static void BM_PlayerWinsRandomGame(benchmark::State &st)
+static void BM_PlayRandomGame(benchmark::State &st)
 {
     omp::XoroShiro128Plus rng(st.thread_index() + st.iterations());
     Deck deck = Deck::createFullDeck();
@@ -305,13 +505,13 @@ static void BM_PlayerWinsRandomGame(benchmark::State &st)
     deckForGame.removeCards(tableCards);
     for (auto _ : st)
     {
-        bool result = playerWinsRandomGame(rng, playerCards, tableCards, deckForGame, numPlayers);
+        std::size_t result = playRandomGame(rng, playerCards, tableCards, deckForGame, numPlayers);
         benchmark::DoNotOptimize(result);
     }
 }
-BENCHMARK(BM_PlayerWinsRandomGame)->DenseRange(2, 10, 1);
+BENCHMARK(BM_PlayRandomGame)->DenseRange(2, 10, 1);
 
-static void BM_PlayerWinsRandomGamePreflop(benchmark::State &st)
+static void BM_PlayRandomGamePreflop(benchmark::State &st)
 {
     omp::XoroShiro128Plus rng(st.thread_index() + st.iterations());
     Deck deck = Deck::createFullDeck();
@@ -322,13 +522,13 @@ static void BM_PlayerWinsRandomGamePreflop(benchmark::State &st)
     deckForGame.removeCards(playerCards);
     for (auto _ : st)
     {
-        bool result = playerWinsRandomGame(rng, playerCards, tableCards, deckForGame, numPlayers);
+        std::size_t result = playRandomGame(rng, playerCards, tableCards, deckForGame, numPlayers);
         benchmark::DoNotOptimize(result);
     }
 }
-BENCHMARK(BM_PlayerWinsRandomGamePreflop)->DenseRange(2, 10, 1);
+BENCHMARK(BM_PlayRandomGamePreflop)->DenseRange(2, 10, 1);
 
-static void BM_PlayerWinsRandomGameFlop(benchmark::State &st)
+static void BM_PlayRandomGameFlop(benchmark::State &st)
 {
     omp::XoroShiro128Plus rng(st.thread_index() + st.iterations());
     Deck deck = Deck::createFullDeck();
@@ -340,13 +540,13 @@ static void BM_PlayerWinsRandomGameFlop(benchmark::State &st)
     deckForGame.removeCards(tableCards);
     for (auto _ : st)
     {
-        bool result = playerWinsRandomGame(rng, playerCards, tableCards, deckForGame, numPlayers);
+        std::size_t result = playRandomGame(rng, playerCards, tableCards, deckForGame, numPlayers);
         benchmark::DoNotOptimize(result);
     }
 }
-BENCHMARK(BM_PlayerWinsRandomGameFlop)->DenseRange(2, 10, 1);
+BENCHMARK(BM_PlayRandomGameFlop)->DenseRange(2, 10, 1);
 
-static void BM_PlayerWinsRandomGameTurn(benchmark::State &st)
+static void BM_PlayRandomGameTurn(benchmark::State &st)
 {
     omp::XoroShiro128Plus rng(st.thread_index() + st.iterations());
     Deck deck = Deck::createFullDeck();
@@ -358,11 +558,11 @@ static void BM_PlayerWinsRandomGameTurn(benchmark::State &st)
     deckForGame.removeCards(tableCards);
     for (auto _ : st)
     {
-        bool result = playerWinsRandomGame(rng, playerCards, tableCards, deckForGame, numPlayers);
+        std::size_t result = playRandomGame(rng, playerCards, tableCards, deckForGame, numPlayers);
         benchmark::DoNotOptimize(result);
     }
 }
-BENCHMARK(BM_PlayerWinsRandomGameTurn)->DenseRange(2, 10, 1);
+BENCHMARK(BM_PlayRandomGameTurn)->DenseRange(2, 10, 1);
 
 // ============================================================================
 // Probability of Winning Benchmarks (Sequential)
@@ -423,6 +623,53 @@ static void BM_ProbabilityOfWinningParallel(benchmark::State &st)
 }
 BENCHMARK(BM_ProbabilityOfWinningParallel)->Ranges({{2, 8}, {10'000, 1'000'000}})->Unit(benchmark::kMillisecond);
 
+static void BM_ProbabilityOfWinningEveryTableSize(benchmark::State &st)
+{
+    Deck playerCards = Deck::parseHand("As Kd");
+    Deck tableCards = Deck::emptyDeck();
+    std::size_t numSimulations = st.range(1);
+    BS::thread_pool<BS::tp::none> threadPool(std::thread::hardware_concurrency());
+    for (auto _ : st)
+    {
+        if (st.range(0) == 0)
+        {
+            for (std::size_t numPlayers = 2; numPlayers <= 10; ++numPlayers)
+            {
+                double probability = probabilityOfWinning(playerCards, tableCards, numSimulations, numPlayers, threadPool);
+                benchmark::DoNotOptimize(probability);
+            }
+            continue;
+        }
+        std::vector<double> probabilities = probabilityOfWinningByPlayers(playerCards, tableCards, numSimulations, 10, threadPool);
+        benchmark::DoNotOptimize(probabilities);
+    }
+}
+BENCHMARK(BM_ProbabilityOfWinningEveryTableSize)->ArgsProduct({{0, 1}, {100'000}})->ArgNames({"single_run", "sims"})->Unit(benchmark::kMillisecond);
+
+// Keeps half of the hardware threads spinning so some pool workers share a core and run
+// at a fraction of the speed of the others, which is what hybrid P/E-core parts and noisy
+// shared hosts look like to the scheduler.
+class BackgroundLoad
+{
+private:
+    std::vector<std::jthread> m_threads;
+
+public:
+    explicit BackgroundLoad(std::size_t numThreads)
+    {
+        for (std::size_t i = 0; i < numThreads; ++i)
+        {
+            m_threads.emplace_back([](std::stop_token stop)
+                                   {
+                std::uint64_t x = 0;
+                while (!stop.stop_requested())
+                {
+                    benchmark::DoNotOptimize(++x);
+                } });
+        }
+    }
+};
+
 static void BM_ProbabilityOfWinningParallelScaling(benchmark::State &st)
 {
     omp::XoroShiro128Plus rng(42);
@@ -431,17 +678,475 @@ static void BM_ProbabilityOfWinningParallelScaling(benchmark::State &st)
     Deck playerCards = allCards.popCards(2);
     Deck tableCards = allCards.popCards(5);
     std::size_t numThreads = st.range(0);
+    bool noisy = st.range(1) != 0;
     std::size_t numSimulations = 100'000;
     std::size_t numPlayers = 6;
     BS::thread_pool<BS::tp::none> threadPool(numThreads);
+    BackgroundLoad load(noisy ? std::max(1u, std::thread::hardware_concurrency() / 2) : 0);
+    std::vector<double> latencies;
     for (auto _ : st)
     {
+        auto start = std::chrono::steady_clock::now();
         double probability = probabilityOfWinning(playerCards, tableCards, numSimulations, numPlayers, threadPool);
+        auto end = std::chrono::steady_clock::now();
+        benchmark::DoNotOptimize(probability);
+        latencies.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    st.SetItemsProcessed(st.iterations() * numSimulations);
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double q)
+    { return latencies[static_cast<std::size_t>(q * static_cast<double>(latencies.size() - 1))]; };
+    st.counters["p50_ms"] = percentile(0.50);
+    st.counters["p99_ms"] = percentile(0.99);
+    st.counters["max_ms"] = latencies.back();
+}
+BENCHMARK(BM_ProbabilityOfWinningParallelScaling)->ArgsProduct({benchmark::CreateDenseRange(1, 16, 1), {0, 1}})->ArgNames({"threads", "noisy"})->Unit(benchmark::kMillisecond);
+
+// Latency of small back-to-back calls, the featurizer's access pattern: 5000 trials on the
+// thread pool (executor=0) against the pinned spinning executor (executor=1) with the same
+// number of threads.
+static void BM_SmallCallLatency(benchmark::State &st)
+{
+    Deck playerCards = Deck::parseHand("As Kd");
+    Deck tableCards = Deck::parseHand("Qs 7h 2c");
+    constexpr std::size_t numSimulations = 5'000;
+    constexpr std::size_t numPlayers = 4;
+    const std::size_t numThreads = std::max(1u, std::thread::hardware_concurrency());
+    BS::thread_pool<BS::tp::none> threadPool(numThreads);
+    PinnedExecutor executor(numThreads - 1);
+    std::vector<double> latencies;
+    for (auto _ : st)
+    {
+        auto start = std::chrono::steady_clock::now();
+        double probability = st.range(0) == 0 ? probabilityOfWinning(playerCards, tableCards, numSimulations, numPlayers, threadPool)
+                                              : probabilityOfWinning(playerCards, tableCards, numSimulations, numPlayers, executor);
+        auto end = std::chrono::steady_clock::now();
         benchmark::DoNotOptimize(probability);
+        latencies.push_back(std::chrono::duration<double, std::micro>(end - start).count());
     }
     st.SetItemsProcessed(st.iterations() * numSimulations);
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double q)
+    { return latencies[static_cast<std::size_t>(q * static_cast<double>(latencies.size() - 1))]; };
+    st.counters["p50_us"] = percentile(0.50);
+    st.counters["p99_us"] = percentile(0.99);
+}
+BENCHMARK(BM_SmallCallLatency)->Arg(0)->Arg(1)->ArgNames({"executor"})->Unit(benchmark::kMicrosecond);
+
+// ============================================================================
+// Equity Engine Benchmarks
+// ============================================================================
+
+static void BM_HandPotential(benchmark::State &state)
+{
+    Deck playerCards = Deck::parseHand("qs js");
+    Deck tableCards = state.range(0) == 3 ? Deck::parseHand("ts 4s 9d") : Deck::parseHand("ts 4s 9d 2h");
+    std::size_t lookahead = static_cast<std::size_t>(state.range(1));
+    BS::thread_pool<BS::tp::none> threadPool(std::thread::hardware_concurrency());
+    for (auto _ : state)
+    {
+        HandPotential potential = handPotential(playerCards, tableCards, lookahead, threadPool);
+        benchmark::DoNotOptimize(potential);
+    }
+}
+BENCHMARK(BM_HandPotential)->Args({3, 1})->Args({3, 2})->Args({4, 1})->ArgNames({"board", "lookahead"})->Unit(benchmark::kMillisecond);
+
+// Per-next-card equity from the flop: one shared-deal run against one probabilityOfWinning
+// call per card at the same per-card trial count.
+static void BM_RunoutBreakdown(benchmark::State &state)
+{
+    Deck playerCards = Deck::parseHand("ah kh");
+    Deck tableCards = Deck::parseHand("qh jh 2c");
+    constexpr std::size_t trialsPerCard = 20'000;
+    BS::thread_pool<BS::tp::none> threadPool(std::thread::hardware_concurrency());
+    Deck unseen = Deck::createFullDeck();
+    unseen.removeCards(playerCards);
+    unseen.removeCards(tableCards);
+    for (auto _ : state)
+    {
+        if (state.range(0) == 0)
+        {
+            for (Card card : unseen)
+            {
+                double probability = probabilityOfWinning(playerCards, Deck::createDeck({tableCards, Deck::createDeck({card})}), trialsPerCard, 3, threadPool);
+                benchmark::DoNotOptimize(probability);
+            }
+            continue;
+        }
+        RunoutBreakdown breakdown = runoutBreakdown(playerCards, tableCards, trialsPerCard, 3, threadPool);
+        benchmark::DoNotOptimize(breakdown);
+    }
+}
+BENCHMARK(BM_RunoutBreakdown)->Arg(0)->Arg(1)->ArgName("shared")->Unit(benchmark::kMillisecond);
+
+// All 169 preflop classes: one shared-deal heatmap against one probabilityOfWinning call per
+// class (first combo of each class) at the same number of deals.
+static void BM_StartingHandEquity(benchmark::State &state)
+{
+    constexpr std::size_t deals = 2'000;
+    BS::thread_pool<BS::tp::none> threadPool(std::thread::hardware_concurrency());
+    for (auto _ : state)
+    {
+        if (state.range(0) == 0)
+        {
+            for (const auto &combos : startingHandCombos)
+            {
+                double probability = probabilityOfWinning(Deck::fromMask(combos.masks[0]), Deck::emptyDeck(), deals, 6, threadPool);
+                benchmark::DoNotOptimize(probability);
+            }
+            continue;
+        }
+        StartingHandEquity heatmap = startingHandEquity(Deck::emptyDeck(), deals, 6, threadPool);
+        benchmark::DoNotOptimize(heatmap);
+    }
+}
+BENCHMARK(BM_StartingHandEquity)->Arg(0)->Arg(1)->ArgName("shared")->Unit(benchmark::kMillisecond);
+
+static void BM_RiverRangeEquity(benchmark::State &state)
+{
+    Deck board = Deck::parseHand("kh 9h 2c 7d 7s");
+    std::array<float, comboCount> weights;
+    weights.fill(1.0f);
+    for (auto _ : state)
+    {
+        std::array<float, comboCount> equity = riverRangeEquity(board, weights);
+        benchmark::DoNotOptimize(equity);
+    }
+    state.SetItemsProcessed(state.iterations() * comboCount);
+}
+BENCHMARK(BM_RiverRangeEquity)->Unit(benchmark::kMicrosecond);
+
+// The O(n^2) matchup table the sweep replaces, with each combo ranked once up front.
+static void BM_RiverRangeEquityPairwise(benchmark::State &state)
+{
+    Deck board = Deck::parseHand("kh 9h 2c 7d 7s");
+    std::array<float, comboCount> weights;
+    weights.fill(1.0f);
+    for (auto _ : state)
+    {
+        std::array<ClassificationResult, comboCount> ranks;
+        for (std::size_t i = 0; i < comboCount; ++i)
+        {
+            ranks[i] = Hand::classify(Deck::fromMask(board.getMask() | comboMasks[i]));
+        }
+        std::array<float, comboCount> equity{};
+        for (std::size_t hero = 0; hero < comboCount; ++hero)
+        {
+            if (comboMasks[hero] & board.getMask())
+            {
+                continue;
+            }
+            float share = 0.0f;
+            float total = 0.0f;
+            for (std::size_t villain = 0; villain < comboCount; ++villain)
+            {
+                if (comboMasks[villain] & (board.getMask() | comboMasks[hero]))
+                {
+                    continue;
+                }
+                share += weights[villain] * (ranks[hero] > ranks[villain] ? 1.0f : (ranks[hero] == ranks[villain] ? 0.5f : 0.0f));
+                total += weights[villain];
+            }
+            equity[hero] = share / total;
+        }
+        benchmark::DoNotOptimize(equity);
+    }
+    state.SetItemsProcessed(state.iterations() * comboCount);
+}
+BENCHMARK(BM_RiverRangeEquityPairwise)->Unit(benchmark::kMicrosecond);
+
+// Narrowing a villain range to a board the way analysis code does it: union of two ranges,
+// intersection with a third, then removing the combos the board blocks. st.range(0) == 0
+// uses HandRange, 1 the per-combo loop over float arrays and mask tests it replaces.
+static void BM_HandRangeNarrowing(benchmark::State &state)
+{
+    omp::XoroShiro128Plus rng(5);
+    std::array<std::array<float, comboCount>, 3> weights{};
+    for (auto &range : weights)
+    {
+        for (float &weight : range)
+        {
+            weight = static_cast<float>(rng() % 5) / 4.0f;
+        }
+    }
+    const Deck board = Deck::parseHand("Kh 9h 2c 7d 7s");
+    const HandRange first = HandRange::fromWeights(weights[0]);
+    const HandRange second = HandRange::fromWeights(weights[1]);
+    const HandRange third = HandRange::fromWeights(weights[2]);
+    for (auto _ : state)
+    {
+        if (state.range(0) == 0)
+        {
+            HandRange range = (first | second) & third;
+            range.removeBlocked(board);
+            benchmark::DoNotOptimize(range);
+        }
+        else
+        {
+            std::array<float, comboCount> range;
+            for (std::size_t i = 0; i < comboCount; ++i)
+            {
+                range[i] = (comboMasks[i] & board.getMask()) ? 0.0f : std::min(std::max(weights[0][i], weights[1][i]), weights[2][i]);
+            }
+            benchmark::DoNotOptimize(range);
+        }
+    }
+}
+BENCHMARK(BM_HandRangeNarrowing)->Arg(0)->Arg(1)->ArgName("scalar");
+
+// ============================================================================
+// Game Engine Benchmarks
+// ============================================================================
+
+// Cloning a mid-hand state, what every search node or rollout starts with. The copy is a
+// memcpy of sizeof(BasicGame<Seats>) bytes.
+template <std::size_t Seats>
+static void BM_GameClone(benchmark::State &state)
+{
+    omp::XoroShiro128Plus rng(1);
+    BasicGame<Seats> game(Blinds{50, 100});
+    for (std::size_t i = 0; i < Seats; ++i)
+    {
+        game.addPlayer(10000);
+    }
+    game.startNewHand(rng);
+    for (auto _ : state)
+    {
+        BasicGame<Seats> clone = game;
+        benchmark::DoNotOptimize(clone);
+        benchmark::ClobberMemory();
+    }
+    state.counters["bytes"] = sizeof(BasicGame<Seats>);
+}
+BENCHMARK_TEMPLATE(BM_GameClone, 2);
+BENCHMARK_TEMPLATE(BM_GameClone, 6);
+BENCHMARK_TEMPLATE(BM_GameClone, 10);
+
+// Check/call self-play as in the Poker_Game driver, st.range(0) players at a ten-seat table.
+// Stacks are reset whenever someone busts. allocs_per_hand should stay at zero.
+static void BM_SelfPlayHand(benchmark::State &state)
+{
+    omp::XoroShiro128Plus rng(1);
+    Game game(Blinds{50, 100});
+    for (std::int64_t i = 0; i < state.range(0); ++i)
+    {
+        game.addPlayer(10000);
+    }
+    const std::uint64_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+    for (auto _ : state)
+    {
+        game.startNewHand(rng);
+        while (game.state() != GameState::Finished)
+        {
+            ActionStruct a{ActionType::Check, 0};
+            if (game.betData().currentBet > game.currentPlayer().committed)
+            {
+                a = {ActionType::Call, 0};
+            }
+            game.applyAction(rng, a);
+        }
+        for (const Player &p : game.players())
+        {
+            if (p.chips == 0)
+            {
+                game.resetPlayerChips(10000);
+                break;
+            }
+        }
+    }
+    const std::uint64_t allocations = allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+    state.counters["allocs_per_hand"] = static_cast<double>(allocations) / static_cast<double>(state.iterations());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SelfPlayHand)->Arg(2)->Arg(6)->Arg(10)->ArgName("players");
+
+// Call stations on every seat, so hands/s measures the engine and the farm rather than bot
+// think time. Items are hands across all tables.
+static void BM_SimulationFarm(benchmark::State &state)
+{
+    BS::thread_pool<BS::tp::none> pool(std::thread::hardware_concurrency());
+    FarmOptions options;
+    options.tables = 256;
+    options.handsPerTable = 100;
+    std::uint64_t seed = 0;
+    for (auto _ : state)
+    {
+        options.seed = ++seed;
+        FarmResult result;
+        if (state.range(0) == 2)
+        {
+            result = runSimulationFarm(options, pool, {}, CallStationStrategy{}, CallStationStrategy{});
+        }
+        else
+        {
+            result = runSimulationFarm(options, pool, {}, CallStationStrategy{}, CallStationStrategy{}, CallStationStrategy{}, CallStationStrategy{}, CallStationStrategy{}, CallStationStrategy{});
+        }
+        benchmark::DoNotOptimize(result.hands);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(options.tables * options.handsPerTable));
+}
+BENCHMARK(BM_SimulationFarm)->Arg(2)->Arg(6)->ArgName("players")->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// 1024 call-station tables of 6, one hand each per iteration: as separate Game objects
+// (batch:0) or in lockstep through a GameBatch (batch:1). Items are hands.
+static void BM_GameBatchHands(benchmark::State &state)
+{
+    constexpr std::size_t numTables = 1024;
+    constexpr std::size_t numPlayers = 6;
+    const Blinds blinds{50, 100};
+    std::vector<omp::XoroShiro128Plus> rngs;
+    for (std::size_t t = 0; t < numTables; ++t)
+    {
+        rngs.emplace_back(t + 1);
+    }
+    if (state.range(0) == 0)
+    {
+        std::vector<Game> games(numTables, Game(blinds));
+        for (Game &g : games)
+        {
+            for (std::size_t i = 0; i < numPlayers; ++i)
+            {
+                g.addPlayer(10000);
+            }
+        }
+        for (auto _ : state)
+        {
+            for (std::size_t t = 0; t < numTables; ++t)
+            {
+                Game &g = games[t];
+                g.resetPlayerChips(10000);
+                g.startNewHand(rngs[t]);
+                while (g.state() != GameState::Finished)
+                {
+                    const bool facingBet = g.hasCurrentActor() && g.betData().currentBet > g.currentPlayer().committed;
+                    g.applyAction(rngs[t], ActionStruct{facingBet ? ActionType::Call : ActionType::Check, 0});
+                }
+            }
+        }
+    }
+    else
+    {
+        GameBatch batch(numTables, numPlayers, 10000, blinds);
+        std::vector<ActionStruct> actions(numTables, ActionStruct{ActionType::Call, 0});
+        for (auto _ : state)
+        {
+            batch.resetPlayerChips(10000);
+            batch.startNewHand(std::span(rngs));
+            while (batch.step(std::span(rngs), std::span<const ActionStruct>(actions)) > 0)
+            {
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(numTables));
+}
+BENCHMARK(BM_GameBatchHands)->Arg(0)->Arg(1)->ArgName("batch")->Unit(benchmark::kMicrosecond);
+
+// Rebuilds every hand of a recorded 6-handed log from the mapped file; compare with
+// BM_SelfPlayHand/players:6, which plays the same kind of hand from the rng.
+static void BM_HandHistoryReplay(benchmark::State &state)
+{
+    constexpr int numHands = 4096;
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "poker_bench_hand_history.bin";
+    std::filesystem::remove(path);
+    {
+        std::optional<HandRecorder> recorder = HandRecorder::open(path.string().c_str());
+        omp::XoroShiro128Plus rng(1);
+        Game game(Blinds{50, 100});
+        for (int i = 0; i < 6; ++i)
+        {
+            game.addPlayer(10000);
+        }
+        for (int hand = 0; hand < numHands; ++hand)
+        {
+            game.resetPlayerChips(10000);
+            recorder->startNewHand(game, rng);
+            while (game.state() != GameState::Finished)
+            {
+                const bool facingBet = game.hasCurrentActor() && game.betData().currentBet > game.currentPlayer().committed;
+                recorder->applyAction(game, rng, ActionStruct{facingBet ? ActionType::Call : ActionType::Check, 0});
+            }
+        }
+    }
+    std::optional<HandHistory> history = HandHistory::open(path.string().c_str());
+    for (auto _ : state)
+    {
+        for (std::size_t hand = 0; hand < history->size(); ++hand)
+        {
+            benchmark::DoNotOptimize(replayHand(*(*history)[hand])->players()[0].chips);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * numHands);
+    state.counters["bytes_per_hand"] = static_cast<double>(std::filesystem::file_size(path) - sizeof(HandHistoryHeader)) / numHands;
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_HandHistoryReplay)->Unit(benchmark::kMicrosecond);
+
+// Depth-first walk of a heads-up betting tree over fold, check/call, pot raise and shove.
+// Arg 0 copies the game at every node; arg 1 applies and undoes in place through an UndoLog.
+// Items are nodes visited.
+static const std::array<ActionStruct, 4> &searchActions(const BasicGame<2> &game, std::array<ActionStruct, 4> &actions)
+{
+    const BetData &bet = game.betData();
+    const bool facingBet = game.hasCurrentActor() && bet.currentBet > game.currentPlayer().committed;
+    actions = {ActionStruct{ActionType::Fold, 0}, ActionStruct{facingBet ? ActionType::Call : ActionType::Check, 0},
+               ActionStruct{ActionType::Raise, bet.currentBet + bet.pot}, ActionStruct{ActionType::AllIn, 0}};
+    return actions;
+}
+
+static std::size_t searchByCopy(const BasicGame<2> &game, omp::XoroShiro128Plus &rng, int depth)
+{
+    if (depth == 0 || game.state() == GameState::Finished)
+    {
+        return 1;
+    }
+    std::array<ActionStruct, 4> actions;
+    std::size_t nodes = 1;
+    for (const ActionStruct &a : searchActions(game, actions))
+    {
+        BasicGame<2> child = game;
+        child.applyAction(rng, a);
+        nodes += searchByCopy(child, rng, depth - 1);
+    }
+    return nodes;
+}
+
+static std::size_t searchByUndo(BasicGame<2> &game, UndoLog &log, omp::XoroShiro128Plus &rng, int depth)
+{
+    if (depth == 0 || game.state() == GameState::Finished)
+    {
+        return 1;
+    }
+    std::array<ActionStruct, 4> actions;
+    std::size_t nodes = 1;
+    for (const ActionStruct &a : searchActions(game, actions))
+    {
+        game.applyAction(rng, a, log);
+        nodes += searchByUndo(game, log, rng, depth - 1);
+        game.undo(log);
+    }
+    return nodes;
+}
+
+static void BM_SearchTree(benchmark::State &state)
+{
+    constexpr int depth = 8;
+    const bool undo = state.range(0) != 0;
+    omp::XoroShiro128Plus rng(9);
+    BasicGame<2> game(Blinds{50, 100});
+    game.addPlayer(20000);
+    game.addPlayer(20000);
+    game.startNewHand(rng);
+    UndoLog log;
+    std::size_t nodes = 0;
+    for (auto _ : state)
+    {
+        const std::size_t visited = undo ? searchByUndo(game, log, rng, depth) : searchByCopy(game, rng, depth);
+        benchmark::DoNotOptimize(visited);
+        nodes += visited;
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(nodes));
 }
-BENCHMARK(BM_ProbabilityOfWinningParallelScaling)->DenseRange(1, 16, 1)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SearchTree)->Arg(0)->Arg(1)->ArgName("undo")->Unit(benchmark::kMicrosecond);
 
 // ============================================================================
 // Throughput Benchmarks
@@ -483,7 +1188,7 @@ static void BM_SimulationThroughput(benchmark::State &state)
 
     for (auto _ : state)
     {
-        bool result = playerWinsRandomGame(rng, playerCards, tableCards, deck, numPlayers);
+        std::size_t result = playRandomGame(rng, playerCards, tableCards, deck, numPlayers);
         benchmark::DoNotOptimize(result);
         ++simCount;
     }
@@ -1,6 +1,10 @@
 #include "../include/game/game.hpp"
 #include "../include/game.hpp"
+#include "../include/simulation_farm.hpp"
+#include <charconv>
+#include <chrono>
 #include <iostream>
+#include <string_view>
 
 inline constexpr bool anyPlayersHaveSomeChips(const std::span<const Player> players) noexcept
 {
@@ -8,8 +12,45 @@ inline constexpr bool anyPlayersHaveSomeChips(const std::span<const Player> play
                          { return p.chips > 0; }) > 1;
 }
 
-int main()
+// --farm <tables> <hands_per_table>: call-station against equity-threshold bots on every
+// table, spread across the thread pool.
+int runFarm(int argc, const char **argv)
 {
+    FarmOptions options;
+    options.blinds = Blinds{50, 100};
+    options.seed = randomSeed();
+    for (int i = 2; i < 4; ++i)
+    {
+        std::size_t &value = i == 2 ? options.tables : options.handsPerTable;
+        const std::string_view arg = i < argc ? argv[i] : "";
+        auto [ptr, err] = std::from_chars(arg.data(), arg.data() + arg.size(), value);
+        if (err != std::errc() || value == 0)
+        {
+            std::cerr << "Usage: " << argv[0] << " --farm <tables> <hands_per_table>\n";
+            return 1;
+        }
+    }
+    BS::thread_pool<BS::tp::none> threadPool(std::thread::hardware_concurrency());
+    const auto start = std::chrono::steady_clock::now();
+    FarmResult result = runSimulationFarm(options, threadPool, {}, CallStationStrategy{}, EquityThresholdStrategy{}, CallStationStrategy{});
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    const char *names[] = {"call-station", "equity-threshold", "call-station"};
+    std::cerr << "Total hands played: " << result.hands << " (" << static_cast<double>(result.hands) / elapsed.count() << " hands/s)\n";
+    for (std::size_t i = 0; i < result.strategies.size(); ++i)
+    {
+        const StrategyResult &s = result.strategies[i];
+        std::cerr << "Strategy " << i << " (" << names[i] << "): " << s.bigBlindsPer100(options.blinds.bigBlind) << " +/- "
+                  << s.bigBlindsPer100Error(options.blinds.bigBlind) << " bb/100\n";
+    }
+    return 0;
+}
+
+int main(int argc, const char **argv)
+{
+    if (argc > 1 && std::string_view(argv[1]) == "--farm")
+    {
+        return runFarm(argc, argv);
+    }
     omp::XoroShiro128Plus rng(std::random_device{}());
     Blinds blinds{50, 100};
     Game g(blinds);
@@ -1,11 +1,15 @@
 #include "../include/deck.hpp"
 #include "../include/game.hpp"
+#include "../include/sharded_equity.hpp"
+#include "../include/starting_hand_equity.hpp"
+#include <fstream>
 #include <random>
 #include <thread>
 #include <string>
 #include <chrono>
 #include <atomic>
 #include <charconv>
+#include <vector>
 inline constexpr bool checkUniqueCards(const Deck playerCards, const Deck tableCards)
 {
     std::int64_t playerMask = playerCards.getMask();
@@ -17,7 +21,10 @@ bool getParameters(int argc, const char **argv, Deck &playerCards, Deck &tableCa
 {
     if (argc < 4)
     {
-        std::cerr << "Usage: " << argv[0] << " <hand> <table> <num_players> [num_simulations]\n";
+        std::cerr << "Usage: " << argv[0] << " <hand> <table> <num_players> [num_simulations]\n"
+                  << "       " << argv[0] << " --heatmap <table> <num_players> [num_simulations] [--binary <file>]\n"
+                  << "       " << argv[0] << " --coordinator <port> <job arguments...>\n"
+                  << "       " << argv[0] << " --worker <host> <port>\n";
         return false;
     }
     std::string_view playerHand = argv[1];
@@ -71,8 +78,238 @@ bool getParameters(int argc, const char **argv, Deck &playerCards, Deck &tableCa
     return true;
 }
 
+// Poker --heatmap <table> <num_players> [num_simulations] [--binary <file>]
+bool getHeatmapParameters(int argc, const char **argv, Deck &tableCards, std::size_t &numPlayers, std::size_t &simulations, const char *&binaryPath)
+{
+    if (argc < 4)
+    {
+        std::cerr << "Usage: " << argv[0] << " --heatmap <table> <num_players> [num_simulations] [--binary <file>]\n";
+        return false;
+    }
+    std::string_view tableCardsStr = argv[2];
+    tableCards = Deck::parseHand(tableCardsStr);
+    if (tableCards.size() > 5)
+    {
+        std::cerr << "Invalid table cards: " << tableCardsStr << '\n';
+        return false;
+    }
+    std::string_view numPlayersStr = argv[3];
+    auto [ptr, err] = std::from_chars(numPlayersStr.data(), numPlayersStr.data() + numPlayersStr.size(), numPlayers);
+    if (err != std::errc() || numPlayers < 2 || numPlayers > 10)
+    {
+        std::cerr << "Number of players must be between 2 and 10.\n";
+        return false;
+    }
+    int next = 4;
+    if (argc > next && std::string_view(argv[next]) != "--binary")
+    {
+        std::string_view numSimulationsStr = argv[next++];
+        auto [ptr2, err2] = std::from_chars(numSimulationsStr.data(), numSimulationsStr.data() + numSimulationsStr.size(), simulations);
+        if (err2 != std::errc() || simulations < 1 || simulations > 500'000'000)
+        {
+            std::cerr << "Number of simulations must be between 1 and 500,000,000.\n";
+            return false;
+        }
+    }
+    if (argc > next)
+    {
+        if (std::string_view(argv[next]) != "--binary" || argc != next + 2)
+        {
+            std::cerr << "Usage: " << argv[0] << " --heatmap <table> <num_players> [num_simulations] [--binary <file>]\n";
+            return false;
+        }
+        binaryPath = argv[next + 1];
+    }
+    return true;
+}
+
+int writeHeatmap(const StartingHandEquity &heatmap, const char *binaryPath)
+{
+    if (!binaryPath)
+    {
+        heatmap.writeCsv(std::cout);
+        return 0;
+    }
+    std::ofstream file(binaryPath, std::ios::binary);
+    if (!file)
+    {
+        std::cerr << "Could not open " << binaryPath << " for writing.\n";
+        return 1;
+    }
+    heatmap.writeBinary(file);
+    return 0;
+}
+
+int runHeatmap(int argc, const char **argv)
+{
+    Deck tableCards;
+    std::size_t numPlayers = 0;
+    std::size_t simulations = 100'000;
+    const char *binaryPath = nullptr;
+    if (!getHeatmapParameters(argc, argv, tableCards, numPlayers, simulations, binaryPath))
+    {
+        return 1;
+    }
+    BS::thread_pool pool(std::thread::hardware_concurrency());
+    return writeHeatmap(startingHandEquity(tableCards, simulations, numPlayers, pool), binaryPath);
+}
+
+bool parsePort(std::string_view portStr, std::uint16_t &port)
+{
+    auto [ptr, err] = std::from_chars(portStr.data(), portStr.data() + portStr.size(), port);
+    if (err != std::errc())
+    {
+        std::cerr << "Invalid port: " << portStr << '\n';
+        return false;
+    }
+    return true;
+}
+
+// Poker --coordinator <port> <hand> <table> <num_players> [num_simulations]
+// Poker --coordinator <port> --heatmap <table> <num_players> [num_simulations] [--binary <file>]
+// Poker --coordinator <port> --preflop-matrix <output_file>
+// Shards the job and waits for workers to pull every shard.
+int runCoordinator(int argc, const char **argv)
+{
+    std::uint16_t port = 0;
+    if (argc < 4 || !parsePort(argv[2], port))
+    {
+        std::cerr << "Usage: " << argv[0] << " --coordinator <port> <hand> <table> <num_players> [num_simulations]\n"
+                  << "       " << argv[0] << " --coordinator <port> --heatmap <table> <num_players> [num_simulations] [--binary <file>]\n"
+                  << "       " << argv[0] << " --coordinator <port> --preflop-matrix <output_file>\n";
+        return 1;
+    }
+    // The job arguments parse exactly like the single-process modes.
+    std::vector<const char *> jobArgs = {argv[0]};
+    jobArgs.insert(jobArgs.end(), argv + 3, argv + argc);
+    const int jobArgc = static_cast<int>(jobArgs.size());
+    const std::string_view mode = argv[3];
+
+    ShardJob job;
+    job.seed = randomSeed();
+    const char *outputPath = nullptr;
+    if (mode == "--heatmap")
+    {
+        Deck tableCards;
+        std::size_t numPlayers = 0;
+        std::size_t simulations = 100'000;
+        if (!getHeatmapParameters(jobArgc, jobArgs.data(), tableCards, numPlayers, simulations, outputPath))
+        {
+            return 1;
+        }
+        job.kind = ShardJobKind::StartingHands;
+        job.tableMask = tableCards.getMask();
+        job.numPlayers = static_cast<std::uint32_t>(numPlayers);
+        job.total = simulations;
+        job.shardSize = 1'000;
+    }
+    else if (mode == "--preflop-matrix")
+    {
+        if (argc != 5)
+        {
+            std::cerr << "Usage: " << argv[0] << " --coordinator <port> --preflop-matrix <output_file>\n";
+            return 1;
+        }
+        outputPath = argv[4];
+        job.kind = ShardJobKind::PreflopMatrix;
+        job.total = detail::sharedCanonicalBoards().size();
+        job.shardSize = 1'024;
+    }
+    else
+    {
+        Deck playerCards;
+        Deck tableCards;
+        std::size_t numPlayers = 0;
+        std::size_t simulations = 1'000'000;
+        if (!getParameters(jobArgc, jobArgs.data(), playerCards, tableCards, numPlayers, simulations))
+        {
+            return 1;
+        }
+        job.kind = ShardJobKind::Equity;
+        job.playerMask = playerCards.getMask();
+        job.tableMask = tableCards.getMask();
+        job.numPlayers = static_cast<std::uint32_t>(numPlayers);
+        job.total = simulations;
+        job.shardSize = 250'000;
+    }
+
+    std::optional<Socket> listener = Socket::listen(port);
+    if (!listener)
+    {
+        std::cerr << "Could not listen on port " << port << ".\n";
+        return 1;
+    }
+    std::cerr << "Waiting for workers on port " << listener->localPort() << ", " << job.numShards() << " shards.\n";
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::uint64_t> totals = coordinateShards(job, *listener);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cerr << "Time taken: " << std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(end - start).count() << "ms\n";
+    if (totals.empty())
+    {
+        std::cerr << "The job did not complete.\n";
+        return 1;
+    }
+
+    switch (job.kind)
+    {
+    case ShardJobKind::Equity:
+        std::cout << "Probability of winning: " << EquityResult{totals[0], totals[1], totals[2], totals[3], totals[4]}.equity() * 100 << "%\n";
+        return 0;
+    case ShardJobKind::StartingHands:
+    {
+        StartingHandCounts counts;
+        for (std::size_t c = 0; c < startingHandClassCount; ++c)
+        {
+            const std::uint64_t *r = totals.data() + 5 * c;
+            counts.results[c] = EquityResult{r[0], r[1], r[2], r[3], r[4]};
+        }
+        counts.deals = totals.back();
+        return writeHeatmap(startingHandEquity(counts), outputPath);
+    }
+    case ShardJobKind::PreflopMatrix:
+    {
+        std::ofstream file(outputPath, std::ios::binary);
+        if (!file)
+        {
+            std::cerr << "Could not open " << outputPath << " for writing.\n";
+            return 1;
+        }
+        writePreflopMatrix(file, detail::preflopEquity(totals));
+        return 0;
+    }
+    }
+    return 1;
+}
+
+// Poker --worker <host> <port>
+int runWorker(int argc, const char **argv)
+{
+    std::uint16_t port = 0;
+    if (argc != 4 || !parsePort(argv[3], port))
+    {
+        std::cerr << "Usage: " << argv[0] << " --worker <host> <port>\n";
+        return 1;
+    }
+    BS::thread_pool pool(std::thread::hardware_concurrency());
+    std::size_t shards = runShardWorker(argv[2], port, pool);
+    std::cerr << "Completed " << shards << " shards.\n";
+    return 0;
+}
+
 int main(int argc, const char **argv)
 {
+    if (argc > 1 && std::string_view(argv[1]) == "--heatmap")
+    {
+        return runHeatmap(argc, argv);
+    }
+    if (argc > 1 && std::string_view(argv[1]) == "--coordinator")
+    {
+        return runCoordinator(argc, argv);
+    }
+    if (argc > 1 && std::string_view(argv[1]) == "--worker")
+    {
+        return runWorker(argc, argv);
+    }
     Deck playerDeck;
     Deck tableDeck;
     std::size_t numPlayers = 0;
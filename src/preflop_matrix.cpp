@@ -0,0 +1,51 @@
+#include "../include/preflop_matrix.hpp"
+#include <algorithm>
+#include <chrono>
+#include <charconv>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+#include <thread>
+
+int main(int argc, const char **argv)
+{
+    if (argc < 2 || argc > 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " <output_file> [num_threads]\n";
+        return 1;
+    }
+    std::size_t threadCount = std::thread::hardware_concurrency();
+    if (argc == 3)
+    {
+        std::string_view threadsStr = argv[2];
+        auto [ptr, err] = std::from_chars(threadsStr.data(), threadsStr.data() + threadsStr.size(), threadCount);
+        if (err != std::errc() || threadCount < 1)
+        {
+            std::cerr << "Error parsing number of threads: " << threadsStr << '\n';
+            return 1;
+        }
+    }
+    std::ofstream file(argv[1], std::ios::binary);
+    if (!file)
+    {
+        std::cerr << "Could not open " << argv[1] << " for writing.\n";
+        return 1;
+    }
+    // The calling thread works through chunks as well. The pool needs at least one thread:
+    // BS::thread_pool reads 0 as hardware_concurrency(), which would use every core.
+    const std::size_t poolThreads = std::max<std::size_t>(1, threadCount - 1);
+    if (poolThreads + 1 != threadCount)
+    {
+        std::cerr << "Using " << poolThreads + 1 << " threads (the calling thread and " << poolThreads << " pool thread).\n";
+    }
+    BS::thread_pool<BS::tp::none> pool(poolThreads);
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<double> equity = computePreflopMatrix(pool);
+    auto end = std::chrono::high_resolution_clock::now();
+    writePreflopMatrix(file, equity);
+    const StartingHandClass aces = StartingHandClass::fromHand(Deck::parseHand("as ah"));
+    const StartingHandClass kings = StartingHandClass::fromHand(Deck::parseHand("ks kh"));
+    std::cout << "AA vs KK: " << equity[aces.index() * startingHandClassCount + kings.index()] * 100 << "%\n";
+    std::cout << "Time taken: " << std::chrono::duration_cast<std::chrono::duration<double>>(end - start).count() << "s\n";
+    return 0;
+}
@@ -0,0 +1,263 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+#include "../include/deck.hpp"
+#include "../include/random.hpp"
+#include "../include/starting_hands.hpp"
+
+// Throughput and statistical quality of the generators and the card sampling paths built on
+// them. Quality results are reported as counters so they land in --benchmark_format=json next
+// to the timings; a generator or sampling change that skews card frequencies shows up as a
+// p_value collapsing towards zero. Each iteration of a frequency benchmark deals
+// drawsPerIteration times, so --benchmark_min_time controls the sample size (a few minutes
+// reach billions of draws).
+
+namespace
+{
+    constexpr std::size_t drawsPerIteration = 1 << 20;
+
+    enum class SamplingPath
+    {
+        PopPair = 0,
+        PopRandomCards5 = 1,
+        PopRandomCard = 2,
+        DealHands = 3,
+    };
+
+    // Deals one sample from a full deck and returns the dealt mask.
+    template <typename TRng>
+    inline std::uint64_t drawSample(TRng &rng, SamplingPath path)
+    {
+        Deck deck = Deck::createFullDeck();
+        switch (path)
+        {
+        case SamplingPath::PopPair:
+            return deck.popPair(rng).getMask();
+        case SamplingPath::PopRandomCards5:
+            return deck.popRandomCards(rng, 5).getMask();
+        case SamplingPath::PopRandomCard:
+            return Deck::createDeck({deck.popRandomCard(rng)}).getMask();
+        case SamplingPath::DealHands:
+        {
+            Deck board = Deck::emptyDeck();
+            const auto hands = deck.dealHands(rng, 9, board, 5);
+            // Last hand, so the frequencies cover every draw before it too.
+            return hands[8].getMask();
+        }
+        }
+        return 0;
+    }
+
+    // Upper tail of the chi-squared distribution through the Wilson-Hilferty normal
+    // approximation, accurate to a few digits for the 51 and 1325 degrees of freedom here.
+    inline double chiSquaredPValue(double chi2, double degrees)
+    {
+        const double scale = 2.0 / (9.0 * degrees);
+        const double z = (std::cbrt(chi2 / degrees) - (1.0 - scale)) / std::sqrt(scale);
+        return 0.5 * std::erfc(z / std::sqrt(2.0));
+    }
+
+    template <std::size_t Bins>
+    inline void reportChiSquared(benchmark::State &st, const std::array<std::uint64_t, Bins> &counts)
+    {
+        double total = 0.0;
+        for (std::uint64_t count : counts)
+        {
+            total += static_cast<double>(count);
+        }
+        const double expected = total / static_cast<double>(Bins);
+        double chi2 = 0.0;
+        double worst = 0.0;
+        for (std::uint64_t count : counts)
+        {
+            const double diff = static_cast<double>(count) - expected;
+            chi2 += diff * diff / expected;
+            worst = std::max(worst, std::abs(diff) / expected);
+        }
+        const double degrees = static_cast<double>(Bins - 1);
+        st.counters["samples"] = total;
+        st.counters["chi2"] = chi2;
+        st.counters["df"] = degrees;
+        st.counters["p_value"] = chiSquaredPValue(chi2, degrees);
+        st.counters["max_rel_dev"] = worst;
+    }
+
+    // Exact distribution of a multiply-shift mapping of a uniform b-bit slice onto [0, range):
+    // value v receives the slices s with floor(s * range / 2^b) == v. Returns the largest
+    // relative deviation of any value from 1 / range and the total variation distance.
+    inline std::pair<double, double> multiplyShiftBias(unsigned bits, std::uint64_t range)
+    {
+        const std::uint64_t slices = 1ull << bits;
+        std::vector<std::uint64_t> hits(range, 0);
+        // Value v starts at the first slice s with s * range >= v * 2^b.
+        for (std::uint64_t v = 0; v < range; ++v)
+        {
+            const std::uint64_t first = (v * slices + range - 1) / range;
+            const std::uint64_t next = ((v + 1) * slices + range - 1) / range;
+            hits[v] = next - first;
+        }
+        const double expected = static_cast<double>(slices) / static_cast<double>(range);
+        double worst = 0.0;
+        double variation = 0.0;
+        for (std::uint64_t h : hits)
+        {
+            const double diff = static_cast<double>(h) - expected;
+            worst = std::max(worst, std::abs(diff) / expected);
+            variation += std::abs(diff) / static_cast<double>(slices);
+        }
+        return {worst, variation / 2.0};
+    }
+}
+
+// ============================================================================
+// Generator Throughput
+// ============================================================================
+
+template <typename TRng>
+static void BM_GeneratorThroughput(benchmark::State &st)
+{
+    TRng rng(1);
+    std::uint64_t sink = 0;
+    for (auto _ : st)
+    {
+        for (std::size_t i = 0; i < 1024; ++i)
+        {
+            sink ^= rng();
+        }
+    }
+    benchmark::DoNotOptimize(sink);
+    st.SetItemsProcessed(st.iterations() * 1024);
+}
+BENCHMARK_TEMPLATE(BM_GeneratorThroughput, omp::XoroShiro128Plus);
+BENCHMARK_TEMPLATE(BM_GeneratorThroughput, omp::XoShiro256PlusX4);
+
+static void BM_GeneratorBulkFill(benchmark::State &st)
+{
+    omp::XoShiro256PlusX4 rng(1);
+    std::vector<std::uint64_t> values(1024);
+    for (auto _ : st)
+    {
+        rng.fill(values);
+        benchmark::DoNotOptimize(values.data());
+        benchmark::ClobberMemory();
+    }
+    st.SetItemsProcessed(st.iterations() * values.size());
+}
+BENCHMARK(BM_GeneratorBulkFill);
+
+template <typename TRng>
+static void BM_FastUniformIntDistribution(benchmark::State &st)
+{
+    TRng rng(1);
+    omp::FastUniformIntDistribution<unsigned> dist(0, static_cast<unsigned>(st.range(0) - 1));
+    unsigned sink = 0;
+    for (auto _ : st)
+    {
+        for (std::size_t i = 0; i < 1024; ++i)
+        {
+            sink += dist(rng);
+        }
+    }
+    benchmark::DoNotOptimize(sink);
+    st.SetItemsProcessed(st.iterations() * 1024);
+}
+BENCHMARK_TEMPLATE(BM_FastUniformIntDistribution, omp::XoroShiro128Plus)->Arg(52)->ArgNames({"range"});
+BENCHMARK_TEMPLATE(BM_FastUniformIntDistribution, omp::XoShiro256PlusX4)->Arg(52)->ArgNames({"range"});
+
+// ============================================================================
+// Card Sampling Throughput
+// ============================================================================
+
+template <typename TRng>
+static void BM_SamplingThroughput(benchmark::State &st)
+{
+    TRng rng(1);
+    const auto path = static_cast<SamplingPath>(st.range(0));
+    std::uint64_t sink = 0;
+    for (auto _ : st)
+    {
+        for (std::size_t i = 0; i < 1024; ++i)
+        {
+            sink ^= drawSample(rng, path);
+        }
+    }
+    benchmark::DoNotOptimize(sink);
+    st.SetItemsProcessed(st.iterations() * 1024);
+}
+BENCHMARK_TEMPLATE(BM_SamplingThroughput, omp::XoroShiro128Plus)->DenseRange(0, 3)->ArgNames({"path"});
+BENCHMARK_TEMPLATE(BM_SamplingThroughput, omp::XoShiro256PlusX4)->DenseRange(0, 3)->ArgNames({"path"});
+
+// ============================================================================
+// Sampling Quality
+// ============================================================================
+
+// Per-card frequencies of every sampling path (0 popPair, 1 popRandomCards(5), 2
+// popRandomCard, 3 the last hand of dealHands) against a uniform 52-bin expectation.
+template <typename TRng>
+static void BM_CardFrequencyChiSquared(benchmark::State &st)
+{
+    TRng rng(12345);
+    const auto path = static_cast<SamplingPath>(st.range(0));
+    std::array<std::uint64_t, 52> counts{};
+    for (auto _ : st)
+    {
+        for (std::size_t i = 0; i < drawsPerIteration; ++i)
+        {
+            for (std::uint64_t m = drawSample(rng, path); m; m &= m - 1)
+            {
+                ++counts[std::countr_zero(m) % 52];
+            }
+        }
+    }
+    st.SetItemsProcessed(st.iterations() * drawsPerIteration);
+    reportChiSquared(st, counts);
+}
+BENCHMARK_TEMPLATE(BM_CardFrequencyChiSquared, omp::XoroShiro128Plus)->DenseRange(0, 3)->ArgNames({"path"})->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CardFrequencyChiSquared, omp::XoShiro256PlusX4)->DenseRange(0, 3)->ArgNames({"path"})->Unit(benchmark::kMillisecond);
+
+// Two-card combo frequencies, 1326 bins, for the paths that deal a pair (0 popPair, 3
+// dealHands). Catches correlations between the two indices that per-card counts miss.
+template <typename TRng>
+static void BM_PairFrequencyChiSquared(benchmark::State &st)
+{
+    TRng rng(54321);
+    const auto path = static_cast<SamplingPath>(st.range(0));
+    std::array<std::uint64_t, comboCount> counts{};
+    for (auto _ : st)
+    {
+        for (std::size_t i = 0; i < drawsPerIteration; ++i)
+        {
+            ++counts[comboIndex(drawSample(rng, path)) % comboCount];
+        }
+    }
+    st.SetItemsProcessed(st.iterations() * drawsPerIteration);
+    reportChiSquared(st, counts);
+}
+BENCHMARK_TEMPLATE(BM_PairFrequencyChiSquared, omp::XoroShiro128Plus)->Arg(0)->Arg(3)->ArgNames({"path"})->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_PairFrequencyChiSquared, omp::XoShiro256PlusX4)->Arg(0)->Arg(3)->ArgNames({"path"})->Unit(benchmark::kMillisecond);
+
+// Exact bias of the bounded mappings, no sampling involved: 21-bit slices are what
+// FastUniformIntDistribution uses by default (popRandomCards, popRandomCard), 32-bit
+// halves what popPair and dealHands use. Ranges cover every deck size a deal can see.
+static void BM_BoundedMappingBias(benchmark::State &st)
+{
+    const unsigned bits = static_cast<unsigned>(st.range(0));
+    double worst = 0.0;
+    double variation = 0.0;
+    for (auto _ : st)
+    {
+        worst = 0.0;
+        variation = 0.0;
+        for (std::uint64_t range = 2; range <= 52; ++range)
+        {
+            const auto [rangeWorst, rangeVariation] = multiplyShiftBias(bits, range);
+            worst = std::max(worst, rangeWorst);
+            variation = std::max(variation, rangeVariation);
+        }
+    }
+    st.counters["max_rel_bias"] = worst;
+    st.counters["max_total_variation"] = variation;
+}
+BENCHMARK(BM_BoundedMappingBias)->Arg(8)->Arg(21)->Arg(32)->ArgNames({"bits"})->Iterations(1);
@@ -73,6 +73,11 @@ int main(int argc, char **argv)
     std::size_t botSeat = (argc > 4) ? static_cast<std::size_t>(std::atoi(argv[4])) : kDefaultBotSeat;
     std::string model_file = (argc > 5) ? argv[5] : "policy_best.dat"; // Tenta carregar o melhor modelo por padrão
 
+    if (players > Game::maxSeats)
+    {
+        std::cerr << "ERRO: no máximo " << Game::maxSeats << " jogadores por mesa (pedido: " << players << ").\n";
+        return 1;
+    }
     if (botSeat >= static_cast<std::size_t>(players))
         botSeat = 0;
 
@@ -0,0 +1,434 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <vector>
+#include "../include/deck.hpp"
+#include "../include/hand_strength.hpp"
+#include "../include/hand_potential.hpp"
+#include "../include/runout_breakdown.hpp"
+#include "../include/starting_hand_equity.hpp"
+#include "../include/range_equity.hpp"
+#include "../include/preflop_matrix.hpp"
+
+static BS::thread_pool<BS::tp::none> enginePool(std::thread::hardware_concurrency());
+
+TEST(HandStrengthTests, RiverIsSingleExactRunout)
+{
+    Deck hero = Deck::parseHand("ah kd");
+    Deck board = Deck::parseHand("ks 7h 2c 9d 3s");
+    auto result = handStrengthDistribution(hero, board, 2, 48, enginePool);
+    EXPECT_TRUE(result.exact);
+    EXPECT_EQ(result.runouts, 1u);
+    EXPECT_DOUBLE_EQ(result.ehs, riverHandStrength(hero, board, 2));
+    EXPECT_DOUBLE_EQ(result.ehs2, result.ehs * result.ehs);
+    EXPECT_DOUBLE_EQ(std::accumulate(result.histogram.begin(), result.histogram.end(), 0.0), 1.0);
+}
+
+TEST(HandStrengthTests, TurnEnumeratesEveryRiver)
+{
+    Deck hero = Deck::parseHand("8h 9h");
+    Deck board = Deck::parseHand("th jc 2h 3d");
+    auto result = handStrengthDistribution<20>(hero, board, 2, 48, enginePool);
+    Deck rivers = Deck::createFullDeck();
+    rivers.removeCards(hero);
+    rivers.removeCards(board);
+    double sum = 0.0;
+    for (const Card river : rivers)
+    {
+        Deck fullBoard = board;
+        fullBoard.addCard(river);
+        sum += riverHandStrength(hero, fullBoard, 2);
+    }
+    EXPECT_TRUE(result.exact);
+    EXPECT_EQ(result.runouts, 46u);
+    EXPECT_NEAR(result.ehs, sum / 46.0, 1e-12);
+    EXPECT_GT(result.ehs2, result.ehs * result.ehs);
+    EXPECT_NEAR(std::accumulate(result.histogram.begin(), result.histogram.end(), 0.0), 1.0, 1e-12);
+}
+
+TEST(HandStrengthTests, SampledFlopApproachesExact)
+{
+    Deck hero = Deck::parseHand("as qs");
+    Deck board = Deck::parseHand("ks 7s 2d");
+    auto exact = handStrengthDistribution(hero, board, 2, 2000, enginePool);
+    auto sampled = handStrengthDistribution(hero, board, 2, 400, enginePool, 99);
+    EXPECT_TRUE(exact.exact);
+    EXPECT_FALSE(sampled.exact);
+    EXPECT_EQ(exact.runouts, 1081u);
+    EXPECT_EQ(sampled.runouts, 400u);
+    EXPECT_NEAR(sampled.ehs, exact.ehs, 0.03);
+    EXPECT_NEAR(sampled.ehs2, exact.ehs2, 0.03);
+}
+
+static HandPotential naiveHandPotential(const Deck hero, const Deck board, std::size_t lookahead)
+{
+    std::array<std::array<double, 3>, 3> hp{};
+    Deck deck = Deck::createFullDeck();
+    deck.removeCards(hero);
+    deck.removeCards(board);
+    std::vector<Card> cards;
+    for (Card card : deck)
+    {
+        cards.push_back(card);
+    }
+    auto outcome = [](ClassificationResult h, ClassificationResult o) -> std::size_t
+    { return h > o ? 0 : (h == o ? 1 : 2); };
+    for (std::size_t a = 0; a < cards.size(); ++a)
+    {
+        for (std::size_t b = a + 1; b < cards.size(); ++b)
+        {
+            Deck opp = Deck::createDeck({cards[a], cards[b]});
+            std::size_t now = outcome(Hand::classify(Deck::createDeck({hero, board})), Hand::classify(Deck::createDeck({opp, board})));
+            Deck rest = deck;
+            rest.removeCards(opp);
+            std::vector<Card> runoutCards;
+            for (Card card : rest)
+            {
+                runoutCards.push_back(card);
+            }
+            for (std::size_t c = 0; c < runoutCards.size(); ++c)
+            {
+                for (std::size_t d = (lookahead == 2 ? c + 1 : 0); d < (lookahead == 2 ? runoutCards.size() : 1); ++d)
+                {
+                    Deck full = board;
+                    full.addCard(runoutCards[c]);
+                    if (lookahead == 2)
+                    {
+                        full.addCard(runoutCards[d]);
+                    }
+                    hp[now][outcome(Hand::classify(Deck::createDeck({hero, full})), Hand::classify(Deck::createDeck({opp, full})))] += 1.0;
+                }
+            }
+        }
+    }
+    std::array<double, 3> totals{};
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        totals[i] = hp[i][0] + hp[i][1] + hp[i][2];
+    }
+    HandPotential result;
+    result.handStrength = (totals[0] + totals[1] / 2.0) / (totals[0] + totals[1] + totals[2]);
+    result.positivePotential = (hp[2][0] + hp[2][1] / 2.0 + hp[1][0] / 2.0) / (totals[2] + totals[1] / 2.0);
+    result.negativePotential = (hp[0][2] + hp[1][2] / 2.0 + hp[0][1] / 2.0) / (totals[0] + totals[1] / 2.0);
+    return result;
+}
+
+TEST(HandPotentialTests, TurnOneCardLookaheadMatchesNaive)
+{
+    Deck hero = Deck::parseHand("ah 5h");
+    Deck board = Deck::parseHand("kh 9h 2c 7d");
+    HandPotential fast = handPotential(hero, board, 1, enginePool);
+    HandPotential naive = naiveHandPotential(hero, board, 1);
+    EXPECT_NEAR(fast.handStrength, naive.handStrength, 1e-12);
+    EXPECT_NEAR(fast.positivePotential, naive.positivePotential, 1e-12);
+    EXPECT_NEAR(fast.negativePotential, naive.negativePotential, 1e-12);
+    EXPECT_GT(fast.positivePotential, 0.0);
+}
+
+TEST(HandPotentialTests, FlopTwoCardLookaheadMatchesNaive)
+{
+    Deck hero = Deck::parseHand("qs js");
+    Deck board = Deck::parseHand("ts 4s 9d");
+    HandPotential fast = handPotential(hero, board, 2, enginePool);
+    HandPotential naive = naiveHandPotential(hero, board, 2);
+    EXPECT_NEAR(fast.handStrength, naive.handStrength, 1e-12);
+    EXPECT_NEAR(fast.positivePotential, naive.positivePotential, 1e-12);
+    EXPECT_NEAR(fast.negativePotential, naive.negativePotential, 1e-12);
+    EXPECT_GT(fast.effectiveHandStrength(), fast.handStrength);
+}
+
+TEST(HandPotentialTests, RiverHasNoPotential)
+{
+    Deck hero = Deck::parseHand("ah kd");
+    Deck board = Deck::parseHand("ks 7h 2c 9d 3s");
+    HandPotential result = handPotential(hero, board, 2, enginePool);
+    EXPECT_DOUBLE_EQ(result.handStrength, riverHandStrength(hero, board, 2));
+    EXPECT_EQ(result.positivePotential, 0.0);
+    EXPECT_EQ(result.negativePotential, 0.0);
+}
+
+TEST(RunoutBreakdownTests, HeadsUpTurnIsExact)
+{
+    Deck hero = Deck::parseHand("ah 5h");
+    Deck board = Deck::parseHand("kh 9h 2c 7d");
+    RunoutBreakdown breakdown = runoutBreakdown(hero, board, 0, 2, enginePool);
+    ASSERT_TRUE(breakdown.exact);
+    EXPECT_EQ(std::popcount(breakdown.nextCards), 46);
+    Deck unseen = Deck::createFullDeck();
+    unseen.removeCards(hero);
+    unseen.removeCards(board);
+    double total = 0.0;
+    for (Card river : unseen)
+    {
+        Deck fullBoard = Deck::createDeck({board, Deck::createDeck({river})});
+        Deck opponents = unseen;
+        opponents.removeCards(Deck::createDeck({river}));
+        double share = 0.0;
+        std::size_t holdings = 0;
+        for (std::uint64_t first = opponents.getMask(); first; first &= first - 1)
+        {
+            for (std::uint64_t second = first & (first - 1); second; second &= second - 1)
+            {
+                const Deck opp = Deck::fromMask((first & -static_cast<std::int64_t>(first)) | (second & -static_cast<std::int64_t>(second)));
+                const GameResult outcome = compareHands(hero, fullBoard, std::span<const Deck>(&opp, 1));
+                share += outcome == GameResult::Win ? 1.0 : (outcome == GameResult::Tie ? 0.5 : 0.0);
+                ++holdings;
+            }
+        }
+        const double equity = share / static_cast<double>(holdings);
+        EXPECT_DOUBLE_EQ(breakdown.equityFor(river), equity);
+        total += equity;
+    }
+    EXPECT_DOUBLE_EQ(breakdown.average, total / 46.0);
+    EXPECT_DOUBLE_EQ(breakdown.equityFor(Deck::parseHand("3h").popCard()), 1.0);
+}
+
+TEST(RunoutBreakdownTests, FlopBucketsAverageToFlopEquity)
+{
+    Deck hero = Deck::parseHand("ah kh");
+    Deck board = Deck::parseHand("qh jh 2c");
+    RunoutBreakdown breakdown = runoutBreakdown(hero, board, 100'000, 3, enginePool, 2024);
+    EXPECT_FALSE(breakdown.exact);
+    EXPECT_EQ(std::popcount(breakdown.nextCards), 47);
+    // The ten of hearts makes a royal flush regardless of the river.
+    EXPECT_EQ(breakdown.equityFor(Deck::parseHand("th").popCard()), 1.0);
+    EXPECT_GT(breakdown.equityFor(Deck::parseHand("3h").popCard()), breakdown.equityFor(Deck::parseHand("3c").popCard()));
+    // Both runs are seeded, so this compares fixed numbers; the bound is a few standard errors.
+    const EquityResult direct = simulateWins(hero, board, 400'000, 3, enginePool, 2025);
+    EXPECT_NEAR(breakdown.average, direct.equity(), 0.004);
+}
+
+TEST(StartingHandTests, ClassesPartitionEveryCombo)
+{
+    std::size_t total = 0;
+    std::uint64_t seen = 0;
+    for (std::size_t c = 0; c < startingHandClassCount; ++c)
+    {
+        const StartingHandClass handClass = StartingHandClass::fromIndex(c);
+        ASSERT_EQ(startingHandCombos[c].count, handClass.comboCount());
+        for (std::size_t i = 0; i < startingHandCombos[c].count; ++i)
+        {
+            EXPECT_EQ(StartingHandClass::fromHand(Deck::fromMask(startingHandCombos[c].masks[i])), handClass);
+            seen |= startingHandCombos[c].masks[i];
+        }
+        total += startingHandCombos[c].count;
+    }
+    EXPECT_EQ(total, 1326u);
+    EXPECT_EQ(seen, Deck::createFullDeck().getMask());
+    EXPECT_EQ(StartingHandClass::fromHand(Deck::parseHand("ah kh")).name(), "AKs");
+    EXPECT_EQ(StartingHandClass::fromHand(Deck::parseHand("kd as")).name(), "AKo");
+    EXPECT_EQ(StartingHandClass::fromHand(Deck::parseHand("2c 2d")).name(), "22");
+    EXPECT_TRUE(StartingHandClass::fromHand(Deck::parseHand("7s 8s")).isSuited());
+}
+
+TEST(StartingHandEquityTests, PreflopHeadsUpRanksAcesFirst)
+{
+    StartingHandEquity heatmap = startingHandEquity(Deck::emptyDeck(), 20'000, 2, enginePool, 11);
+    EXPECT_EQ(heatmap.deals, 20'000u);
+    const double aces = heatmap.at(0, 0);
+    EXPECT_NEAR(aces, 0.855, 0.01);
+    EXPECT_EQ(*std::max_element(heatmap.equity.begin(), heatmap.equity.end()), aces);
+    EXPECT_GT(heatmap.at(0, 1), heatmap.at(1, 0));
+    EXPECT_LT(heatmap.at(12, 7), 0.4);
+}
+
+TEST(StartingHandEquityTests, BlockedCombosAreRejected)
+{
+    // Three aces on the board leave no pocket-ace combo, and quad aces never lose.
+    StartingHandEquity heatmap = startingHandEquity(Deck::parseHand("as ah ad 7c 2d"), 2'000, 3, enginePool, 5);
+    const std::size_t aces = StartingHandClass{0, 0}.index();
+    EXPECT_EQ(heatmap.equity[aces], 0.0);
+    EXPECT_EQ(heatmap.trials[aces], 0u);
+    const std::size_t aceKing = StartingHandClass::fromHand(Deck::parseHand("ac kc")).index();
+    const StartingHandCounts counts = simulateStartingHands(Deck::parseHand("as ah ad 7c 2d"), 2'000, 3, enginePool, 5);
+    EXPECT_EQ(counts.results[aceKing].losses, 0u);
+    EXPECT_DOUBLE_EQ(heatmap.equity[aceKing], counts.results[aceKing].equity());
+}
+
+TEST(RangeEquityTests, ComboIndexRoundTrips)
+{
+    for (std::size_t i = 0; i < comboCount; ++i)
+    {
+        ASSERT_EQ(std::popcount(comboMasks[i]), 2);
+        EXPECT_EQ(comboIndex(comboMasks[i]), i);
+    }
+}
+
+TEST(RangeEquityTests, SweepMatchesPairwiseMatchups)
+{
+    Deck board = Deck::parseHand("kh 9h 2c 7d 7s");
+    omp::XoroShiro128Plus rng(3);
+    std::array<float, comboCount> weights{};
+    for (float &weight : weights)
+    {
+        weight = static_cast<float>(rng() % 5) / 4.0f;
+    }
+    std::array<float, comboCount> equity = riverRangeEquity(board, weights);
+    for (std::size_t hero = 0; hero < comboCount; hero += 7)
+    {
+        if (comboMasks[hero] & board.getMask())
+        {
+            EXPECT_EQ(equity[hero], 0.0f);
+            continue;
+        }
+        const ClassificationResult heroResult = Hand::classify(Deck::fromMask(board.getMask() | comboMasks[hero]));
+        double share = 0.0;
+        double total = 0.0;
+        for (std::size_t villain = 0; villain < comboCount; ++villain)
+        {
+            if (comboMasks[villain] & (board.getMask() | comboMasks[hero]))
+            {
+                continue;
+            }
+            const ClassificationResult villainResult = Hand::classify(Deck::fromMask(board.getMask() | comboMasks[villain]));
+            share += weights[villain] * (heroResult > villainResult ? 1.0 : (heroResult == villainResult ? 0.5 : 0.0));
+            total += weights[villain];
+        }
+        EXPECT_NEAR(equity[hero], share / total, 1e-6) << hero;
+    }
+}
+
+TEST(RangeEquityTests, UniformRangeMatchesRiverHandStrength)
+{
+    Deck board = Deck::parseHand("ks 7h 2c 9d 3s");
+    std::array<float, comboCount> weights;
+    weights.fill(1.0f);
+    std::array<float, comboCount> equity = riverRangeEquity(board, weights);
+    Deck hero = Deck::parseHand("ah kd");
+    EXPECT_NEAR(equity[comboIndex(hero.getMask())], riverHandStrength(hero, board, 2), 1e-6);
+}
+
+TEST(HandRangeTests, SetOperationsMatchScalarLoops)
+{
+    omp::XoroShiro128Plus rng(21);
+    std::array<float, comboCount> lhsWeights{};
+    std::array<float, comboCount> rhsWeights{};
+    for (std::size_t i = 0; i < comboCount; ++i)
+    {
+        lhsWeights[i] = static_cast<float>(rng() % 5) / 4.0f;
+        rhsWeights[i] = static_cast<float>(rng() % 3) / 2.0f;
+    }
+    const HandRange lhs = HandRange::fromWeights(lhsWeights);
+    const HandRange rhs = HandRange::fromWeights(rhsWeights);
+    const HandRange unite = lhs | rhs;
+    const HandRange intersect = lhs & rhs;
+    const HandRange product = lhs * rhs;
+    for (std::size_t i = 0; i < comboCount; ++i)
+    {
+        EXPECT_EQ(unite[i], std::max(lhsWeights[i], rhsWeights[i]));
+        EXPECT_EQ(intersect[i], std::min(lhsWeights[i], rhsWeights[i]));
+        EXPECT_EQ(product[i], lhsWeights[i] * rhsWeights[i]);
+    }
+    // The vector paths must agree with constant evaluation.
+    static constexpr HandRange aces = []
+    {
+        HandRange range;
+        range.set(StartingHandClass::fromHand(Deck::parseHand("as ah")), 1.0f);
+        return range;
+    }();
+    static constexpr HandRange constantUnion = aces | HandRange::full() * aces;
+    EXPECT_EQ(aces | HandRange::full() * aces, constantUnion);
+    static_assert(constantUnion.size() == 6 && (HandRange::full() & aces) == aces);
+}
+
+TEST(HandRangeTests, RemoveBlockedMatchesMaskTests)
+{
+    const Deck dead = Deck::parseHand("as kd 7h 7c 2s");
+    HandRange range = HandRange::full();
+    range.removeBlocked(dead);
+    static constexpr HandRange constantRange = HandRange::full().removeBlocked(Deck::parseHand("as kd 7h 7c 2s"));
+    EXPECT_EQ(range, constantRange);
+    for (std::size_t i = 0; i < comboCount; ++i)
+    {
+        EXPECT_EQ(range[i], (comboMasks[i] & dead.getMask()) ? 0.0f : 1.0f) << i;
+    }
+    EXPECT_EQ(range.size(), Deck::binomial(47, 2));
+    EXPECT_DOUBLE_EQ(range.totalWeight(), static_cast<double>(Deck::binomial(47, 2)));
+}
+
+TEST(HandRangeTests, ClassWeightsExpandToCombos)
+{
+    std::array<float, startingHandClassCount> classWeights{};
+    const StartingHandClass suitedConnector = StartingHandClass::fromHand(Deck::parseHand("9h 8h"));
+    const StartingHandClass offsuitBroadway = StartingHandClass::fromHand(Deck::parseHand("ah kd"));
+    classWeights[suitedConnector.index()] = 0.5f;
+    classWeights[offsuitBroadway.index()] = 1.0f;
+    const HandRange range = HandRange::fromClasses(classWeights);
+    EXPECT_EQ(range.size(), 4u + 12u);
+    EXPECT_DOUBLE_EQ(range.totalWeight(), 4 * 0.5 + 12 * 1.0);
+    EXPECT_EQ(range.weight(Deck::parseHand("9s 8s")), 0.5f);
+    EXPECT_EQ(range.weight(Deck::parseHand("9s 8c")), 0.0f);
+    const Deck board = Deck::parseHand("kh 9h 2c 7d 7s");
+    EXPECT_EQ(riverRangeEquity(board, range), riverRangeEquity(board, range.weights()));
+}
+
+TEST(PreflopMatrixTests, CanonicalBoardsCoverEveryBoard)
+{
+    std::vector<detail::WeightedBoard> boards = detail::canonicalBoards();
+    EXPECT_EQ(boards.size(), 134'459u);
+    std::uint64_t total = 0;
+    for (const auto &board : boards)
+    {
+        total += board.weight;
+    }
+    EXPECT_EQ(total, Deck::binomial(52, 5));
+}
+
+TEST(PreflopMatrixTests, BoardSweepMatchesPairwiseMatchups)
+{
+    detail::PreflopPoints sweep;
+    auto scratch = std::make_unique<detail::PreflopScratch>();
+    std::vector<std::uint64_t> naive(preflopMatrixCells, 0);
+    for (std::string_view boardStr : {"as ks qs js ts", "7h 7d 2c 2s 9h", "kh 9h 2c 7d 3s"})
+    {
+        const std::uint64_t board = Deck::parseHand(boardStr).getMask();
+        detail::accumulatePreflopBoard(board, 3, sweep, *scratch);
+        std::array<ClassificationResult, comboCount> ranks;
+        for (std::size_t i = 0; i < comboCount; ++i)
+        {
+            ranks[i] = Hand::classify(Deck::fromMask(board | comboMasks[i]));
+        }
+        for (std::size_t hero = 0; hero < comboCount; ++hero)
+        {
+            for (std::size_t villain = 0; villain < comboCount; ++villain)
+            {
+                if ((comboMasks[hero] | comboMasks[villain]) & board || comboMasks[hero] & comboMasks[villain])
+                {
+                    continue;
+                }
+                naive[comboClasses[hero] * startingHandClassCount + comboClasses[villain]] += 3 * (ranks[hero] > ranks[villain] ? 2 : (ranks[hero] == ranks[villain] ? 1 : 0));
+            }
+        }
+    }
+    EXPECT_EQ(sweep.points, naive);
+}
+
+TEST(PreflopMatrixTests, FileRoundTripsThroughMapping)
+{
+    std::vector<double> equity(preflopMatrixCells);
+    for (std::size_t i = 0; i < equity.size(); ++i)
+    {
+        equity[i] = static_cast<double>(i) / static_cast<double>(equity.size());
+    }
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "poker_preflop_matrix_test.bin";
+    {
+        std::ofstream file(path, std::ios::binary);
+        writePreflopMatrix(file, equity);
+    }
+    std::optional<PreflopMatrix> matrix = PreflopMatrix::load(path.string().c_str());
+    ASSERT_TRUE(matrix.has_value());
+    EXPECT_TRUE(std::equal(equity.begin(), equity.end(), matrix->values().begin()));
+    EXPECT_EQ(matrix->equity(StartingHandClass{0, 0}, StartingHandClass{1, 1}), equity[14]);
+
+    // Flip one payload byte: the checksum must reject the file.
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(sizeof(PreflopMatrixHeader) + 100);
+        file.put('\x7f');
+    }
+    EXPECT_FALSE(PreflopMatrix::load(path.string().c_str()).has_value());
+    std::filesystem::remove(path);
+    EXPECT_FALSE(PreflopMatrix::load(path.string().c_str()).has_value());
+}
@@ -1,8 +1,13 @@
 #include <gtest/gtest.h>
 #include <array>
+#include <algorithm>
+#include <vector>
 #include "../include/deck.hpp"
 #include "../include/hand.hpp"
 #include "../include/game.hpp"
+#include "../include/async_equity.hpp"
+#include "../include/pinned_executor.hpp"
+#include "../include/simulation_farm.hpp"
 
 static BS::thread_pool<BS::tp::none> threadPool(std::thread::hardware_concurrency());
 inline double calculateProbability(const std::string_view playerHand, const std::string_view boardCards, std::size_t numSimulations, std::size_t numPlayers)
@@ -20,8 +25,9 @@ TEST(ExecutionTests, RoyalFlushTest)
 
 TEST(ExecutionTests, RoyalFlushOnTheBoard)
 {
+    // Everyone plays the board, so the pot is always split eight ways.
     double probability = calculateProbability("2c 7d", "ts js qs ks as", 500'000, 8);
-    EXPECT_EQ(probability, 1.0);
+    EXPECT_DOUBLE_EQ(probability, 1.0 / 8);
 }
 
 TEST(ExecutionTests, UnbeatableQuads)
@@ -46,16 +52,19 @@ TEST(ExecutionTests, QHighFlushVsTheFieldOnA4SpadeBoard)
 
 TEST(ExecutionTests, TwoPairOnTheBoardKickerWars)
 {
+    // Hero is unbeaten ~20.6% of the time, but most of those pots are split with other aces.
     double probability = calculateProbability("ac ks", "td 9c 9s th 2h", 500'000, 8);
-    EXPECT_GE(probability, 0.18);
-    EXPECT_LE(probability, 0.22);
+    EXPECT_GE(probability, 0.11);
+    EXPECT_LE(probability, 0.13);
 }
 
 TEST(ExecutionTests, StraightOnPairedBoardVsTheField) // Nome corrigido
 {
+    // Hero is unbeaten ~74.5% of the time, but every opponent holding a jack splits the
+    // same queen-high straight.
     double probability = calculateProbability("jh 6h", "qs 8d ts td 9c", 500'000, 8);
-    EXPECT_GE(probability, 0.74);
-    EXPECT_LE(probability, 0.75);
+    EXPECT_GE(probability, 0.46);
+    EXPECT_LE(probability, 0.48);
 }
 
 TEST(ExecutionTests, JHighFlushVsTheField)
@@ -63,4 +72,287 @@ TEST(ExecutionTests, JHighFlushVsTheField)
     double probability = calculateProbability("jh 6h", "qs 8h th 2h 3d", 500'000, 8);
     EXPECT_GE(probability, 0.86);
     EXPECT_LE(probability, 0.89);
-}
\ No newline at end of file
+}
+
+TEST(ChunkSchedulerTests, ClaimsEveryIndexExactlyOnce)
+{
+    ChunkScheduler scheduler(10'001, 64);
+    std::vector<int> seen(10'001, 0);
+    ChunkRange chunk;
+    std::size_t chunks = 0;
+    while (scheduler.claim(chunk))
+    {
+        for (std::size_t i = chunk.begin; i < chunk.end; ++i)
+        {
+            ++seen[i];
+        }
+        ++chunks;
+    }
+    EXPECT_EQ(chunks, scheduler.numChunks());
+    EXPECT_TRUE(std::all_of(seen.begin(), seen.end(), [](int c)
+                            { return c == 1; }));
+}
+
+TEST(ChunkSchedulerTests, SeededRunIsIndependentOfThreadCount)
+{
+    Deck player = Deck::parseHand("ah kd");
+    Deck board = Deck::parseHand("qs 7h 2c");
+    // Explicit pool sizes, so the chunk layout would differ between the two runs on any
+    // host if it were derived from the pool.
+    BS::thread_pool<BS::tp::none> singleThread(1);
+    BS::thread_pool<BS::tp::none> sevenThreads(7);
+    EquityResult a = simulateWins(player, board, 100'000, 4, singleThread, 1234);
+    EquityResult b = simulateWins(player, board, 100'000, 4, sevenThreads, 1234);
+    EXPECT_EQ(ChunkScheduler::chunkSizeFor(100'000, ChunkScheduler::seededWorkers), 97u);
+    EXPECT_EQ(a.trials(), 100'000u);
+    EXPECT_EQ(a.wins, b.wins);
+    EXPECT_EQ(a.ties, b.ties);
+    EXPECT_EQ(a.potShare, b.potShare);
+}
+
+TEST(ChunkSchedulerTests, StopRequestSkipsRemainingChunks)
+{
+    std::stop_source source;
+    source.request_stop();
+    EquityResult counts = simulateWins(Deck::parseHand("ah kd"), Deck::emptyDeck(), 1'000'000, 4, threadPool, 7, source.get_token());
+    EXPECT_EQ(counts.trials(), 0u);
+    EXPECT_EQ(counts.equity(), 0.0);
+}
+
+TEST(EquityByPlayersTests, LargestTableMatchesSingleCountRun)
+{
+    // With maxPlayers = N the survival walk consumes the generator exactly like the
+    // N-player simulation, so a seeded run reproduces it bit for bit.
+    Deck player = Deck::parseHand("ah kd");
+    Deck board = Deck::parseHand("qs 7h 2c");
+    SimulationCountsByPlayers byPlayers = simulateWinsByPlayers(player, board, 100'000, 6, threadPool, 99);
+    EquityResult single = simulateWins(player, board, 100'000, 6, threadPool, 99);
+    EquityResult largest = byPlayers.counts(6);
+    EXPECT_EQ(largest.wins, single.wins);
+    EXPECT_EQ(largest.ties, single.ties);
+    EXPECT_EQ(largest.losses, single.losses);
+    EXPECT_EQ(largest.potShare, single.potShare);
+}
+
+TEST(EquityByPlayersTests, EquityDecreasesWithTableSize)
+{
+    std::vector<double> equities = probabilityOfWinningByPlayers(Deck::parseHand("as ah"), Deck::emptyDeck(), 200'000, 10, threadPool);
+    ASSERT_EQ(equities.size(), 9u);
+    EXPECT_NEAR(equities[0], 0.85, 0.01);
+    for (std::size_t i = 1; i < equities.size(); ++i)
+    {
+        EXPECT_LE(equities[i], equities[i - 1]);
+        EXPECT_NEAR(equities[i], probabilityOfWinning(Deck::parseHand("as ah"), Deck::emptyDeck(), 200'000, i + 2, threadPool), 0.01);
+    }
+}
+
+TEST(EquityByPlayersTests, RoyalFlushOnTheBoardSplitsAtEveryTableSize)
+{
+    std::vector<double> equities = probabilityOfWinningByPlayers(Deck::parseHand("2h 3d"), Deck::parseHand("as ks qs js ts"), 10'000, 8, threadPool);
+    ASSERT_EQ(equities.size(), 7u);
+    for (std::size_t i = 0; i < equities.size(); ++i)
+    {
+        EXPECT_DOUBLE_EQ(equities[i], 1.0 / static_cast<double>(i + 2));
+    }
+}
+
+TEST(AsyncEquityTests, CompletesAllTrials)
+{
+    AsyncEquity handle = probabilityOfWinningAsync(Deck::parseHand("as ks"), Deck::parseHand("qs js ts 2h 3d"), 50'000, 8, threadPool);
+    EquityEstimate result = handle.get();
+    EXPECT_TRUE(handle.done());
+    EXPECT_EQ(result.trials, 50'000u);
+    EXPECT_EQ(result.equity, 1.0);
+    EXPECT_EQ(result.standardError, 0.0);
+}
+
+TEST(AsyncEquityTests, DeadlineReturnsPartialEstimate)
+{
+    AsyncEquity handle = probabilityOfWinningAsync(Deck::parseHand("jh 6h"), Deck::parseHand("qs 8h th 2h 3d"), std::numeric_limits<std::size_t>::max(), 8, threadPool);
+    EquityEstimate result = handle.estimateBy(std::chrono::steady_clock::now() + std::chrono::milliseconds(50));
+    EXPECT_GT(result.trials, 0u);
+    EXPECT_GT(result.standardError, 0.0);
+    EXPECT_NEAR(result.equity, 0.875, std::max(0.02, 4 * result.standardError));
+    EXPECT_TRUE(handle.waitFor(std::chrono::seconds(5)));
+}
+
+TEST(AsyncEquityTests, CancelStopsWorkers)
+{
+    AsyncEquity handle = probabilityOfWinningAsync(Deck::parseHand("ah kd"), Deck::emptyDeck(), std::numeric_limits<std::size_t>::max(), 4, threadPool);
+    handle.cancel();
+    EXPECT_TRUE(handle.waitFor(std::chrono::seconds(5)));
+    std::size_t trials = handle.estimate().trials;
+    EXPECT_EQ(handle.estimate().trials, trials);
+}
+
+TEST(AsyncEquityTests, MovedFromHandleIsEmpty)
+{
+    AsyncEquity first = probabilityOfWinningAsync(Deck::parseHand("as ks"), Deck::parseHand("qs js ts 2h 3d"), 10'000, 4, threadPool);
+    AsyncEquity second = std::move(first);
+    EXPECT_FALSE(first.valid());
+    EXPECT_TRUE(first.done());
+    EXPECT_TRUE(first.waitFor(std::chrono::milliseconds(0)));
+    EXPECT_EQ(first.get().trials, 0u);
+    first.cancel();
+    ASSERT_TRUE(second.valid());
+    EXPECT_EQ(second.get().trials, 10'000u);
+}
+
+TEST(PinnedExecutorTests, ParsesKernelCpuLists)
+{
+    EXPECT_EQ(detail::parseCpuList("0-3,8,10-11\n"), (std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    EXPECT_EQ(detail::parseCpuList("5"), std::vector<int>{5});
+    EXPECT_TRUE(detail::parseCpuList("").empty());
+}
+
+TEST(PinnedExecutorTests, SpreadPlacementAlternatesNodes)
+{
+    const std::vector<std::vector<int>> nodes = {{0, 1, 2}, {4, 5}};
+    EXPECT_EQ(detail::placeWorkers(6, WorkerPlacement::Spread, nodes), (std::vector<int>{0, 4, 1, 5, 2, 0}));
+    EXPECT_EQ(detail::placeWorkers(4, WorkerPlacement::Compact, nodes), (std::vector<int>{0, 1, 2, 4}));
+}
+
+TEST(PinnedExecutorTests, RunsEveryParticipantOncePerJob)
+{
+    PinnedExecutor executor(3);
+    for (int job = 0; job < 100; ++job)
+    {
+        std::array<std::atomic<int>, 4> calls{};
+        executor.run([&](std::size_t participant)
+                     { calls[participant].fetch_add(1); });
+        for (const auto &count : calls)
+        {
+            EXPECT_EQ(count.load(), 1);
+        }
+    }
+}
+
+#ifdef __linux__
+TEST(PinnedExecutorTests, PinsCallerOnlyWhileRunning)
+{
+    cpu_set_t before;
+    ASSERT_EQ(pthread_getaffinity_np(pthread_self(), sizeof(before), &before), 0);
+    PinnedExecutor executor(1);
+    cpu_set_t idle;
+    ASSERT_EQ(pthread_getaffinity_np(pthread_self(), sizeof(idle), &idle), 0);
+    EXPECT_TRUE(CPU_EQUAL(&before, &idle));
+    int cpusDuringRun = 0;
+    executor.run([&](std::size_t participant)
+                 {
+        if (participant == 0)
+        {
+            cpu_set_t during;
+            CPU_ZERO(&during);
+            pthread_getaffinity_np(pthread_self(), sizeof(during), &during);
+            cpusDuringRun = CPU_COUNT(&during);
+        } });
+    EXPECT_EQ(cpusDuringRun, 1);
+    cpu_set_t after;
+    ASSERT_EQ(pthread_getaffinity_np(pthread_self(), sizeof(after), &after), 0);
+    EXPECT_TRUE(CPU_EQUAL(&before, &after));
+}
+#endif
+
+TEST(PinnedExecutorTests, SeededRunMatchesThreadPool)
+{
+    Deck player = Deck::parseHand("ah kd");
+    Deck board = Deck::parseHand("qs 7h 2c");
+    PinnedExecutor executor(2, {.pin = false});
+    EquityResult pinned = simulateWins(player, board, 100'000, 4, executor, 1234);
+    EquityResult pooled = simulateWins(player, board, 100'000, 4, threadPool, 1234);
+    EXPECT_EQ(pinned.trials(), 100'000u);
+    EXPECT_EQ(pinned.wins, pooled.wins);
+    EXPECT_EQ(pinned.potShare, pooled.potShare);
+    EXPECT_NEAR(probabilityOfWinning(Deck::parseHand("as ah"), Deck::emptyDeck(), 5'000, 2, executor), 0.85, 0.03);
+}
+
+TEST(EquityResultTests, SplitPotsCountOneKth)
+{
+    EquityResult result;
+    result.add(1);
+    result.add(0);
+    result.add(2);
+    result.add(3);
+    EXPECT_EQ(result.trials(), 4u);
+    EXPECT_EQ(result.wins, 1u);
+    EXPECT_EQ(result.ties, 2u);
+    EXPECT_EQ(result.losses, 1u);
+    EXPECT_DOUBLE_EQ(result.equity(), (1.0 + 0.5 + 1.0 / 3) / 4);
+    EXPECT_DOUBLE_EQ(result.tieProbability(), 0.5);
+}
+
+TEST(EquityResultTests, UnsupportedTableSizesGiveEmptyResults)
+{
+    Deck player = Deck::parseHand("ah kd");
+    EXPECT_EQ(simulateWins(player, Deck::emptyDeck(), 1'000, 1, threadPool, 3).trials(), 0u);
+    EXPECT_EQ(simulateWins(player, Deck::emptyDeck(), 1'000, EquityResult::maxPlayers + 1, threadPool, 3).trials(), 0u);
+    EXPECT_EQ(simulateWins(player, Deck::emptyDeck(), 1'000, EquityResult::maxPlayers, threadPool, 3).trials(), 1'000u);
+    EXPECT_FALSE(probabilityOfWinningAsync(player, Deck::emptyDeck(), 1'000, 0, threadPool).valid());
+}
+
+TEST(EquityResultTests, TiesAreSeparatedFromWinsInOnePass)
+{
+    // Both players hold a ten-high straight whenever the board does not pair up into a
+    // better hand, so a large share of trials split the pot.
+    omp::XoroShiro128Plus rng(5);
+    EquityResult result = simulateEquity(rng, Deck::parseHand("6h 2c"), Deck::parseHand("7d 8s 9c ts"), 200'000, 2);
+    EXPECT_GT(result.tieProbability(), 0.1);
+    EXPECT_NEAR(result.equity(), result.winProbability() + result.tieProbability() / 2, 1e-12);
+    EXPECT_LT(result.equity(), result.winProbability() + result.tieProbability());
+    EXPECT_GT(result.standardError(), 0.0);
+}
+
+TEST(SimulationFarmTests, EverySeatPlaysEveryHand)
+{
+    FarmOptions options;
+    options.tables = 16;
+    options.handsPerTable = 50;
+    options.seed = 99;
+    FarmResult result = runSimulationFarm(options, threadPool, {}, CallStationStrategy{}, CallStationStrategy{}, CallStationStrategy{});
+    ASSERT_EQ(result.strategies.size(), 3u);
+    EXPECT_EQ(result.hands, 800u);
+    std::int64_t net = 0;
+    for (const StrategyResult &s : result.strategies)
+    {
+        EXPECT_EQ(s.hands, 800u);
+        net += s.netChips;
+    }
+    // Nobody folds, so every pot is shown down and no chips leave the table.
+    EXPECT_EQ(net, 0);
+}
+
+TEST(SimulationFarmTests, SeededRunIsIndependentOfThreadCount)
+{
+    FarmOptions options;
+    options.tables = 8;
+    options.handsPerTable = 20;
+    options.seed = 4321;
+    const EquityThresholdStrategy tight{0.5, 0.8, 50};
+    BS::thread_pool<BS::tp::none> singleThread(1);
+    FarmResult a = runSimulationFarm(options, singleThread, {}, CallStationStrategy{}, tight);
+    FarmResult b = runSimulationFarm(options, threadPool, {}, CallStationStrategy{}, tight);
+    ASSERT_EQ(a.strategies.size(), b.strategies.size());
+    for (std::size_t i = 0; i < a.strategies.size(); ++i)
+    {
+        EXPECT_EQ(a.strategies[i].netChips, b.strategies[i].netChips) << i;
+        EXPECT_EQ(a.strategies[i].handsWon, b.strategies[i].handsWon) << i;
+    }
+}
+
+TEST(SimulationFarmTests, TypeErasedLineupMatchesCompileTimeLineup)
+{
+    FarmOptions options;
+    options.tables = 4;
+    options.handsPerTable = 25;
+    options.seed = 5;
+    const EquityThresholdStrategy tight{0.5, 0.8, 50};
+    const std::vector<AnyStrategy> lineup{CallStationStrategy{}, tight, CallStationStrategy{}};
+    FarmResult erased = runSimulationFarm(options, threadPool, lineup);
+    FarmResult typed = runSimulationFarm(options, threadPool, {}, CallStationStrategy{}, tight, CallStationStrategy{});
+    ASSERT_EQ(erased.strategies.size(), 3u);
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        EXPECT_EQ(erased.strategies[i].netChips, typed.strategies[i].netChips) << i;
+        EXPECT_EQ(erased.strategies[i].hands, typed.strategies[i].hands) << i;
+    }
+}
@@ -1,5 +1,9 @@
 #include "../include/game/game.hpp"
+#include "../include/game/game_batch.hpp"
+#include "../include/game/hand_history.hpp"
 #include "../include/game/pot_manager.hpp"
+#include <cstring>
+#include <filesystem>
 #include <numeric>
 #include <gtest/gtest.h>
 
@@ -153,6 +157,23 @@ TEST(GameSetup, DealsExactlyTwoCardsPerPlayer)
     }
 }
 
+TEST(GameSetup, FullTableRejectsAnotherPlayer)
+{
+    Game g(Blinds{50, 100});
+    for (std::size_t i = 0; i < Game::maxSeats; ++i)
+    {
+        ASSERT_TRUE(g.addPlayer(1000));
+    }
+    EXPECT_FALSE(g.addPlayer(1000));
+    EXPECT_EQ(g.players().size(), Game::maxSeats);
+
+    BasicGame<2> headsUp(Blinds{50, 100});
+    EXPECT_TRUE(headsUp.addPlayer(1000));
+    EXPECT_TRUE(headsUp.addPlayer(1000));
+    EXPECT_FALSE(headsUp.addPlayer(1000));
+    EXPECT_EQ(headsUp.players().size(), 2u);
+}
+
 TEST(GameSetup, ChipsConservedAfterBlinds)
 {
     constexpr Blinds blinds{50, 100};
@@ -525,6 +546,26 @@ TEST(PotManagerTest, TotalEqualsInvestments)
     }());
 }
 
+TEST(PotManagerTest, SeatSetIteratesInSeatOrder)
+{
+    static_assert([]() {
+        SeatSet seats;
+        seats.insert(9);
+        seats.insert(0);
+        seats.insert(4);
+        std::size_t previous = 0;
+        std::size_t visited = 0;
+        for (std::size_t seat : seats)
+        {
+            if (visited++ > 0 && seat <= previous)
+                return false;
+            previous = seat;
+        }
+        return visited == 3 && seats.size() == 3 && seats.contains(4) && !seats.contains(5)
+            && (seats & SeatSet::firstSeats(5)).size() == 2;
+    }());
+}
+
 // ========== Edge Cases ==========
 
 TEST(EdgeCases, HeadsUpBlinds)
@@ -582,3 +623,458 @@ TEST(EdgeCases, FinishedGameReturnsTrue)
     bool result = g.applyAction(rng, {ActionType::Check, 0});
     EXPECT_TRUE(result);
 }
+
+// ========== Fixed-Capacity Game Tests ==========
+
+TEST(FixedCapacityGame, CopiesAreIndependentSnapshots)
+{
+    static_assert(std::is_trivially_copyable_v<BasicGame<2>> && std::is_trivially_copyable_v<Game>);
+    static_assert(Game::maxSeats == 10 && sizeof(BasicGame<2>) < 200);
+    constexpr Blinds blinds{50, 100};
+    omp::XoroShiro128Plus rng{42};
+    auto g = make_game(3, 10000, blinds);
+    g.startNewHand(rng);
+    Game snapshot(blinds);
+    std::memcpy(static_cast<void *>(&snapshot), &g, sizeof(Game));
+    play_all_check_call(g, rng);
+    EXPECT_EQ(g.state(), GameState::Finished);
+    EXPECT_EQ(snapshot.state(), GameState::PreFlop);
+    EXPECT_EQ(snapshot.players().size(), 3u);
+    EXPECT_EQ(snapshot.betData().pot, blinds.smallBlind + blinds.bigBlind);
+    // The snapshot plays on by itself and conserves chips.
+    play_all_check_call(snapshot, rng);
+    EXPECT_EQ(sum_chips(snapshot.players()), 30000);
+}
+
+TEST(FixedCapacityGame, HeadsUpTableMatchesFullRing)
+{
+    constexpr Blinds blinds{50, 100};
+    omp::XoroShiro128Plus fullRng{7};
+    omp::XoroShiro128Plus headsUpRng{7};
+    Game full(blinds);
+    BasicGame<2> headsUp(blinds);
+    for (std::size_t i = 0; i < 2; ++i)
+    {
+        full.addPlayer(1000);
+        headsUp.addPlayer(1000);
+    }
+    for (int hand = 0; hand < 20; ++hand)
+    {
+        full.startNewHand(fullRng);
+        headsUp.startNewHand(headsUpRng);
+        while (full.state() != GameState::Finished)
+        {
+            ASSERT_EQ(headsUp.state(), full.state());
+            ActionStruct a{ActionType::Check, 0};
+            if (full.betData().currentBet > full.currentPlayer().committed)
+            {
+                a = {hand % 3 == 0 ? ActionType::AllIn : ActionType::Call, 0};
+            }
+            full.applyAction(fullRng, a);
+            headsUp.applyAction(headsUpRng, a);
+        }
+        ASSERT_EQ(headsUp.state(), GameState::Finished);
+        for (std::size_t i = 0; i < 2; ++i)
+        {
+            EXPECT_EQ(headsUp.players()[i].chips, full.players()[i].chips);
+        }
+        if (full.players()[0].chips == 0 || full.players()[1].chips == 0)
+        {
+            break;
+        }
+    }
+}
+
+TEST(FixedCapacityGame, SeatMasksTrackPlayerFlags)
+{
+    constexpr Blinds blinds{50, 100};
+    omp::XoroShiro128Plus rng{99};
+    auto g = make_game(6, 2000, blinds);
+    auto expectConsistent = [&g]()
+    {
+        for (const Player &p : g.players())
+        {
+            ASSERT_EQ(g.aliveSeats().contains(p.id), p.alive()) << p.id;
+            ASSERT_EQ(g.eligibleSeats().contains(p.id), p.eligible()) << p.id;
+            ASSERT_EQ(g.allInSeats().contains(p.id), p.all_in) << p.id;
+        }
+    };
+    for (int hand = 0; hand < 200; ++hand)
+    {
+        g.startNewHand(rng);
+        expectConsistent();
+        while (g.state() != GameState::Finished)
+        {
+            // Mix folds, raises and shoves so every mask changes.
+            const std::uint64_t roll = rng() % 10;
+            ActionStruct a{ActionType::Call, 0};
+            if (roll == 0)
+            {
+                a = {ActionType::Fold, 0};
+            }
+            else if (roll == 1)
+            {
+                a = {ActionType::AllIn, 0};
+            }
+            else if (roll == 2)
+            {
+                a = {ActionType::Raise, 0};
+            }
+            g.applyAction(rng, a);
+            expectConsistent();
+        }
+        if (std::count_if(g.players().begin(), g.players().end(), [](const Player &p)
+                          { return p.chips > 0; }) < 2)
+        {
+            g.resetPlayerChips(2000);
+        }
+    }
+}
+
+// Folds, checks, calls, pot-sized raises and shoves, drawn from the table's action rng.
+static ActionStruct randomAction(omp::XoroShiro128Plus &rng, const BetData &bet)
+{
+    switch (rng() % 8)
+    {
+    case 0:
+        return {ActionType::Fold, 0};
+    case 1:
+        return {ActionType::AllIn, 0};
+    case 2:
+        return {ActionType::Raise, bet.currentBet + bet.pot};
+    case 3:
+        return {ActionType::Bet, bet.pot / 2};
+    case 4:
+        return {ActionType::Check, 0};
+    default:
+        return {ActionType::Call, 0};
+    }
+}
+
+TEST(GameBatchTest, MatchesIndependentGamesWithTheSameSeeds)
+{
+    constexpr std::size_t numTables = 48;
+    constexpr std::size_t numPlayers = 6;
+    constexpr std::uint32_t chips = 2000;
+    const Blinds blinds{25, 50};
+
+    std::vector<Game> games(numTables, Game(blinds));
+    std::vector<omp::XoroShiro128Plus> gameDeals, gameActions, batchDeals, batchActions;
+    for (std::size_t t = 0; t < numTables; ++t)
+    {
+        for (std::size_t seat = 0; seat < numPlayers; ++seat)
+        {
+            games[t].addPlayer(chips);
+        }
+        gameDeals.emplace_back(1000 + t);
+        gameActions.emplace_back(5000 + t);
+        batchDeals.emplace_back(1000 + t);
+        batchActions.emplace_back(5000 + t);
+    }
+    GameBatch batch(numTables, numPlayers, chips, blinds);
+    std::vector<ActionStruct> actions(numTables);
+
+    for (int hand = 0; hand < 40; ++hand)
+    {
+        for (std::size_t t = 0; t < numTables; ++t)
+        {
+            Game &g = games[t];
+            g.startNewHand(gameDeals[t]);
+            while (g.state() != GameState::Finished)
+            {
+                // The batch pays showdowns within the step that reaches them, so only draw
+                // an action where the batch would take a step.
+                const ActionStruct a = g.state() == GameState::Showdown ? ActionStruct{ActionType::Check, 0} : randomAction(gameActions[t], g.betData());
+                g.applyAction(gameDeals[t], a);
+            }
+        }
+
+        batch.startNewHand(std::span(batchDeals));
+        std::size_t running = numTables;
+        while (running > 0)
+        {
+            for (std::size_t t = 0; t < numTables; ++t)
+            {
+                if (batch.state(t) != GameState::Finished)
+                {
+                    actions[t] = randomAction(batchActions[t], batch.betData(t));
+                }
+            }
+            running = batch.step(std::span(batchDeals), std::span<const ActionStruct>(actions));
+        }
+
+        for (std::size_t t = 0; t < numTables; ++t)
+        {
+            ASSERT_EQ(batch.state(t), GameState::Finished);
+            EXPECT_EQ(batch.boards()[t], games[t].board().getMask()) << "hand " << hand << " table " << t;
+            for (std::size_t seat = 0; seat < numPlayers; ++seat)
+            {
+                ASSERT_EQ(batch.chips(seat, t), games[t].players()[seat].chips) << "hand " << hand << " table " << t << " seat " << seat;
+                ASSERT_EQ(batch.holes(seat)[t] != 0, games[t].players()[seat].has_hole);
+            }
+            ASSERT_EQ(batch.aliveSeats(t), games[t].aliveSeats());
+            ASSERT_EQ(batch.allInSeats(t), games[t].allInSeats());
+        }
+    }
+}
+
+TEST(GameBatchTest, SeatCountBeyondMaxSeatsGivesEmptyBatch)
+{
+    GameBatch full(4, GameBatch::maxSeats, 1000, Blinds{50, 100});
+    EXPECT_EQ(full.numTables(), 4u);
+    EXPECT_EQ(full.numPlayers(), GameBatch::maxSeats);
+
+    GameBatch tooWide(4, GameBatch::maxSeats + 1, 1000, Blinds{50, 100});
+    EXPECT_EQ(tooWide.numTables(), 0u);
+    EXPECT_EQ(tooWide.numPlayers(), 0u);
+    std::vector<omp::XoroShiro128Plus> rngs(4, omp::XoroShiro128Plus(1));
+    tooWide.startNewHand(std::span(rngs));
+    EXPECT_EQ(tooWide.numTables(), 0u);
+}
+
+TEST(GameBatchTest, SeatColumnsAreContiguousAcrossTables)
+{
+    GameBatch batch(5, 3, 1000, Blinds{50, 100});
+    std::vector<omp::XoroShiro128Plus> rngs;
+    for (std::size_t t = 0; t < 5; ++t)
+    {
+        rngs.emplace_back(t);
+    }
+    batch.startNewHand(std::span(rngs));
+    // Dealer is seat 0, so seat 1 posts the small blind and seat 2 the big blind everywhere.
+    for (std::size_t t = 0; t < 5; ++t)
+    {
+        EXPECT_EQ(batch.chips(1)[t], 950u);
+        EXPECT_EQ(batch.chips(2)[t], 900u);
+        EXPECT_EQ(batch.committed(2)[t], 100u);
+        EXPECT_EQ(batch.betData(t).pot, 150u);
+        EXPECT_EQ(batch.currentSeat(t), 0u);
+    }
+    EXPECT_EQ(batch.chips(1).size(), 5u);
+
+    std::vector<ActionStruct> folds(5, ActionStruct{ActionType::Fold, 0});
+    EXPECT_EQ(batch.step(std::span(rngs), std::span<const ActionStruct>(folds)), 5u);
+    EXPECT_EQ(batch.foldedSeats(0), SeatSet::fromMask(0b001));
+    EXPECT_EQ(batch.currentSeat(0), 1u);
+}
+
+static void expectSameState(const Game &replayed, const Game &original)
+{
+    ASSERT_EQ(replayed.state(), original.state());
+    EXPECT_EQ(replayed.board().getMask(), original.board().getMask());
+    EXPECT_EQ(replayed.betData().pot, original.betData().pot);
+    EXPECT_EQ(replayed.betData().currentBet, original.betData().currentBet);
+    EXPECT_EQ(replayed.aliveSeats(), original.aliveSeats());
+    EXPECT_EQ(replayed.hasCurrentActor(), original.hasCurrentActor());
+    ASSERT_EQ(replayed.players().size(), original.players().size());
+    for (std::size_t i = 0; i < original.players().size(); ++i)
+    {
+        EXPECT_EQ(replayed.players()[i].chips, original.players()[i].chips) << i;
+        EXPECT_EQ(replayed.players()[i].committed, original.players()[i].committed) << i;
+        // Seats that sat the hand out keep whatever cards they held last.
+        ASSERT_EQ(replayed.players()[i].has_hole, original.players()[i].has_hole) << i;
+        if (original.players()[i].has_hole)
+        {
+            EXPECT_EQ(replayed.players()[i].hole.getMask(), original.players()[i].hole.getMask()) << i;
+        }
+    }
+}
+
+TEST(HandHistoryTest, ReplayRebuildsEveryStateWithoutTheRng)
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "poker_hand_history_test.bin";
+    std::filesystem::remove(path);
+    std::vector<Game> finals;
+    std::vector<std::vector<Game>> steps;
+    {
+        std::optional<HandRecorder> recorder = HandRecorder::open(path.string().c_str());
+        ASSERT_TRUE(recorder.has_value());
+        Game g(Blinds{25, 50});
+        for (int i = 0; i < 6; ++i)
+        {
+            g.addPlayer(3000);
+        }
+        omp::XoroShiro128Plus rng(77);
+        for (int hand = 0; hand < 150; ++hand)
+        {
+            if (std::count_if(g.players().begin(), g.players().end(), [](const Player &p)
+                              { return p.chips > 0; }) < 2)
+            {
+                g.resetPlayerChips(3000);
+            }
+            recorder->startNewHand(g, rng);
+            steps.emplace_back(1, g);
+            while (g.state() != GameState::Finished)
+            {
+                recorder->applyAction(g, rng, randomAction(rng, g.betData()));
+                steps.back().push_back(g);
+            }
+            finals.push_back(g);
+        }
+        EXPECT_EQ(recorder->handsWritten(), 150u);
+        EXPECT_TRUE(recorder->flush());
+    }
+
+    std::optional<HandHistory> history = HandHistory::open(path.string().c_str());
+    ASSERT_TRUE(history.has_value());
+    ASSERT_EQ(history->size(), 150u);
+    for (std::size_t hand = 0; hand < history->size(); ++hand)
+    {
+        std::optional<HandRecord> record = (*history)[hand];
+        ASSERT_TRUE(record.has_value());
+        ASSERT_EQ(record->numActions() + 1, steps[hand].size());
+        std::optional<Game> replayed = replayHand(*record);
+        ASSERT_TRUE(replayed.has_value());
+        expectSameState(*replayed, finals[hand]);
+        std::optional<HandReplay> replay = HandReplay::create(*record);
+        ASSERT_TRUE(replay.has_value());
+        for (std::size_t action = 0; action < steps[hand].size(); ++action)
+        {
+            ASSERT_EQ(replay->position(), action);
+            expectSameState(replay->game(), steps[hand][action]);
+            replay->step();
+        }
+        EXPECT_FALSE(replay->step());
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(HandHistoryTest, AppendsToExistingLogAndSkipsTruncatedRecord)
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "poker_hand_history_append_test.bin";
+    std::filesystem::remove(path);
+    omp::XoroShiro128Plus rng(3);
+    Game g(Blinds{50, 100});
+    g.addPlayer(1000);
+    g.addPlayer(1000);
+    auto playHands = [&](int count)
+    {
+        std::optional<HandRecorder> recorder = HandRecorder::open(path.string().c_str());
+        ASSERT_TRUE(recorder.has_value());
+        for (int hand = 0; hand < count; ++hand)
+        {
+            g.resetPlayerChips(1000);
+            recorder->startNewHand(g, rng);
+            while (g.state() != GameState::Finished)
+            {
+                recorder->applyAction(g, rng, ActionStruct{ActionType::Call, 0});
+            }
+        }
+    };
+    playHands(3);
+    playHands(2);
+    ASSERT_EQ(HandHistory::open(path.string().c_str())->size(), 5u);
+
+    // A crash mid-write leaves part of a record behind; readers stop before it.
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 3);
+    std::optional<HandHistory> history = HandHistory::open(path.string().c_str());
+    ASSERT_TRUE(history.has_value());
+    EXPECT_EQ(history->size(), 4u);
+    std::filesystem::remove(path);
+}
+
+TEST(HandHistoryTest, ReplayRejectsRecordsWiderThanItsTable)
+{
+    // Twelve seats parse, since the format allows up to maxTableSeats, but do not fit a Game.
+    std::vector<std::uint8_t> body;
+    detail::appendVarint(body, 12);
+    detail::appendVarint(body, 50);
+    detail::appendVarint(body, 100);
+    for (int seat = 0; seat < 12; ++seat)
+    {
+        detail::appendVarint(body, 1000);
+    }
+    body.push_back(0);
+    std::optional<HandRecord> record = HandRecord::parse(body);
+    ASSERT_TRUE(record.has_value());
+    EXPECT_EQ(record->numSeats(), 12u);
+    EXPECT_FALSE(HandReplay::create(*record).has_value());
+    EXPECT_FALSE(replayHand(*record).has_value());
+    EXPECT_TRUE(BasicHandReplay<maxTableSeats>::create(*record).has_value());
+}
+
+// Undo restores fields in place and leaves padding alone, so a state it restores is
+// byte-for-byte the copy taken before the action, deck included.
+static bool sameBytes(const Game &a, const Game &b)
+{
+    return std::memcmp(&a, &b, sizeof(Game)) == 0;
+}
+
+static void searchWithUndo(Game &g, UndoLog &log, omp::XoroShiro128Plus &rng, int depth, std::size_t &nodes)
+{
+    ++nodes;
+    if (depth == 0 || g.state() == GameState::Finished)
+    {
+        return;
+    }
+    for (int child = 0; child < 2; ++child)
+    {
+        const Game before = g;
+        const ActionStruct a = randomAction(rng, g.betData());
+        Game copied = g;
+        omp::XoroShiro128Plus copyRng = rng;
+        copied.applyAction(copyRng, a);
+        g.applyAction(rng, a, log);
+        expectSameState(g, copied);
+        searchWithUndo(g, log, rng, depth - 1, nodes);
+        ASSERT_TRUE(g.undo(log));
+        ASSERT_TRUE(sameBytes(g, before)) << "depth " << depth;
+    }
+}
+
+TEST(UndoLogTest, UndoRestoresEveryNodeOfARandomSearch)
+{
+    Game g(Blinds{25, 50});
+    for (int i = 0; i < 4; ++i)
+    {
+        g.addPlayer(1500 + 500 * i);
+    }
+    omp::XoroShiro128Plus rng(11);
+    UndoLog log;
+    std::size_t nodes = 0;
+    for (int hand = 0; hand < 20; ++hand)
+    {
+        g.startNewHand(rng);
+        searchWithUndo(g, log, rng, 8, nodes);
+        EXPECT_TRUE(log.empty());
+        EXPECT_FALSE(g.undo(log));
+    }
+    EXPECT_GT(nodes, 2000u);
+}
+
+TEST(UndoLogTest, RedoDealsTheSameCardsAgain)
+{
+    Game g(Blinds{50, 100});
+    g.addPlayer(5000);
+    g.addPlayer(5000);
+    g.addPlayer(5000);
+    omp::XoroShiro128Plus rng(5);
+    UndoLog log;
+    g.startNewHand(rng);
+    const Game start = g;
+    while (g.state() != GameState::Finished)
+    {
+        g.applyAction(rng, ActionStruct{ActionType::Call, 0}, log);
+    }
+    const Game end = g;
+    ASSERT_EQ(g.board().size(), 5u);
+
+    const std::size_t actions = log.size();
+    while (g.undo(log))
+    {
+    }
+    EXPECT_TRUE(sameBytes(g, start));
+    EXPECT_EQ(g.board().size(), 0u);
+    for (std::size_t i = 0; i < actions; ++i)
+    {
+        ASSERT_TRUE(g.redo(log));
+    }
+    EXPECT_FALSE(g.redo(log));
+    EXPECT_TRUE(sameBytes(g, end));
+
+    // A new action after an undo starts another line; the undone one is gone.
+    ASSERT_TRUE(g.undo(log));
+    EXPECT_TRUE(log.canRedo());
+    g.applyAction(rng, ActionStruct{ActionType::Fold, 0}, log);
+    EXPECT_FALSE(log.canRedo());
+}
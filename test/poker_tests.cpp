@@ -1,4 +1,6 @@
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
 #include "../include/hand.hpp"
 #include "../include/deck.hpp"
 #include "../include/card.hpp"
@@ -375,6 +377,278 @@ TEST(DeckTest, PopRandomCards)
     }
 }
 
+TEST(DeckTest, DealHands)
+{
+    static constexpr Deck hero = Deck::parseHand("as kd");
+    static constexpr auto dealt = []
+    {
+        Deck board = Deck::parseHand("2c");
+        Deck deck = Deck::createFullDeck();
+        deck.removeCards(hero);
+        deck.removeCards(board);
+        omp::XoroShiro128Plus rng{7};
+        auto hands = deck.dealHands(rng, 9, board, 4);
+        return std::pair{hands, std::pair{board, deck}};
+    }();
+    static constexpr auto hands = dealt.first;
+    static constexpr Deck board = dealt.second.first;
+    static constexpr Deck rest = dealt.second.second;
+    std::uint64_t seen = hero.getMask() | board.getMask() | rest.getMask();
+    for (std::size_t i = 0; i < 9; ++i)
+    {
+        EXPECT_EQ(hands[i].size(), 2u);
+        EXPECT_EQ(hands[i].getMask() & seen, 0u);
+        seen |= hands[i].getMask();
+    }
+    EXPECT_EQ(hands[9].size(), 0u);
+    static_assert(board.size() == 5 && (board.getMask() & Deck::parseHand("2c").getMask()) != 0);
+    EXPECT_EQ(rest.size(), 49u - 18u - 4u);
+    EXPECT_EQ(seen, Deck::createFullDeck().getMask());
+}
+
+TEST(DeckTest, DealHandsIsUniform)
+{
+    // Every card should land in the last hand equally often.
+    omp::XoroShiro128Plus rng{11};
+    std::array<std::size_t, 52> counts{};
+    constexpr std::size_t deals = 520'000;
+    for (std::size_t i = 0; i < deals; ++i)
+    {
+        Deck deck = Deck::createFullDeck();
+        auto hands = deck.dealHands(rng, 10);
+        for (std::uint64_t m = hands[9].getMask(); m; m &= m - 1)
+        {
+            ++counts[std::countr_zero(m)];
+        }
+    }
+    const double expected = 2.0 * deals / 52;
+    for (std::size_t count : counts)
+    {
+        EXPECT_NEAR(static_cast<double>(count), expected, 0.03 * expected);
+    }
+}
+
+TEST(DeckTest, IndexRoundTrips)
+{
+    static_assert(Deck::binomial(52, 5) == 2'598'960 && Deck::binomial(52, 26) == 495'918'532'948'104ull);
+    static_assert(Deck::emptyDeck().index() == 0 && Deck::createFullDeck().index() == 0);
+    static_assert(Deck::fromIndex(5, 0).getMask() == 0x1F);
+    static_assert(Deck::fromIndex(5, Deck::binomial(52, 5) - 1).getMask() == 0x1Full << 47);
+    static_assert(Deck::parseHand("as kd 7h").index() == Deck::fromIndex(3, Deck::parseHand("as kd 7h").index()).index());
+    // Every 2-card mask maps densely onto [0, 1326).
+    std::vector<bool> seen(Deck::binomial(52, 2), false);
+    for (std::uint64_t first = 0; first < 52; ++first)
+    {
+        for (std::uint64_t second = first + 1; second < 52; ++second)
+        {
+            const Deck pair = Deck::fromMask((1ull << first) | (1ull << second));
+            const std::uint64_t i = pair.index();
+            ASSERT_LT(i, seen.size());
+            EXPECT_FALSE(seen[i]);
+            seen[i] = true;
+            EXPECT_EQ(Deck::fromIndex(2, i).getMask(), pair.getMask());
+        }
+    }
+    omp::XoroShiro128Plus rng{3};
+    for (std::size_t k = 1; k <= 7; ++k)
+    {
+        for (std::size_t trial = 0; trial < 1000; ++trial)
+        {
+            Deck deck = Deck::createFullDeck();
+            const Deck cards = deck.popRandomCards(rng, k);
+            EXPECT_LT(cards.index(), Deck::binomial(52, k));
+            EXPECT_EQ(Deck::fromIndex(k, cards.index()).getMask(), cards.getMask());
+        }
+    }
+}
+
+TEST(DeckTest, SubsetsSplitIntoRanges)
+{
+    Deck deck = Deck::createFullDeck();
+    deck.removeCards(Deck::parseHand("as kd 7h 7c 2s"));
+    static_assert([]
+                  {
+        std::size_t count = 0;
+        for (const Deck subset : Deck::parseHand("as kd 7h 7c").subsets(2))
+        {
+            count += subset.size() == 2;
+        }
+        return count; }() == 6);
+    // Subsets come out in colex order, so their rank is their position in the range.
+    const auto all = deck.subsets(3);
+    ASSERT_EQ(all.size(), Deck::binomial(47, 3));
+    std::vector<std::uint64_t> masks;
+    std::uint64_t position = 0;
+    for (auto it = all.begin(); it != all.end(); ++it, ++position)
+    {
+        const Deck subset = *it;
+        EXPECT_EQ(it.index(), position);
+        EXPECT_EQ(subset.size(), 3u);
+        EXPECT_EQ(subset.getMask() & ~deck.getMask(), 0u);
+        masks.push_back(subset.getMask());
+    }
+    EXPECT_TRUE(std::is_sorted(masks.begin(), masks.end()));
+    // Uneven ranges starting mid-enumeration concatenate to the full sequence.
+    std::vector<std::uint64_t> pieces;
+    const std::uint64_t step = all.size() / 7 + 1;
+    for (std::uint64_t first = 0; first < all.size(); first += step)
+    {
+        for (const Deck subset : deck.subsets(3, first, first + step))
+        {
+            pieces.push_back(subset.getMask());
+        }
+    }
+    EXPECT_EQ(pieces, masks);
+    EXPECT_EQ(deck.subsets(3, all.size(), all.size() + 10).size(), 0u);
+    EXPECT_EQ(deck.subsets(0).size(), 1u);
+    EXPECT_EQ((*deck.subsets(0).begin()).size(), 0u);
+    EXPECT_EQ(deck.subsets(48).size(), 0u);
+}
+
+TEST(BitSelectTest, SelectBitMatchesScan)
+{
+    static_assert(selectBit(0b1011'0000, 0) == 4 && selectBit(0b1011'0000, 2) == 7 && selectBit(0b1011'0000, 3) == 64);
+    static_assert(selectBit(~0ull, 63) == 63 && selectBit(1ull << 63, 0) == 63 && selectBit(0, 0) == 64);
+    omp::XoroShiro128Plus rng{5};
+    for (std::size_t trial = 0; trial < 10'000; ++trial)
+    {
+        // Vary the density so sparse, dense and byte-straddling masks all show up.
+        std::uint64_t x = rng();
+        x &= trial % 3 == 0 ? rng() : ~0ull;
+        x |= trial % 5 == 0 ? rng() : 0;
+        unsigned k = 0;
+        for (unsigned pos = 0; pos < 64; ++pos)
+        {
+            if (x & (1ull << pos))
+            {
+                ASSERT_EQ(selectBit(x, k), pos) << std::hex << x << " k=" << k;
+                ++k;
+            }
+        }
+        EXPECT_EQ(selectBit(x, k), 64u);
+    }
+}
+
+TEST(BitSelectTest, BothDepositPathsDealTheSameCards)
+{
+    omp::XoroShiro128Plus rng{9};
+    for (std::size_t trial = 0; trial < 10'000; ++trial)
+    {
+        const std::uint64_t mask = rng() & rng() & ((1ull << 52) - 1);
+        const std::uint64_t x = rng() & rng();
+        std::uint64_t expected = 0;
+        std::uint64_t bits = x;
+        for (std::uint64_t m = mask; m && bits; m &= m - 1, bits >>= 1)
+        {
+            expected |= bits & 1 ? m & -static_cast<std::int64_t>(m) : 0;
+        }
+        ASSERT_EQ(depositBitsPortable(x, mask), expected);
+    }
+    const SelectPath autoPath = selectPath();
+    std::array<std::uint64_t, 2> dealt{};
+    for (const SelectPath path : {SelectPath::Pdep, SelectPath::Broadword})
+    {
+        const std::size_t slot = setSelectPath(path) == SelectPath::Pdep ? 0 : 1;
+        omp::XoroShiro128Plus dealRng{13};
+        std::uint64_t hash = 0;
+        for (std::size_t i = 0; i < 1000; ++i)
+        {
+            Deck deck = Deck::createFullDeck();
+            Deck board = Deck::emptyDeck();
+            const auto hands = deck.dealHands(dealRng, 9, board, 5);
+            hash = hash * 31 + (hands[8].getMask() ^ board.getMask() ^ deck.popRandomCards(dealRng, 3).getMask());
+        }
+        dealt[slot] = hash;
+    }
+    EXPECT_EQ(setSelectPath(SelectPath::Auto), autoPath);
+    if (dealt[0] != 0)
+    {
+        EXPECT_EQ(dealt[0], dealt[1]);
+    }
+    EXPECT_NE(dealt[1], 0u);
+}
+
+TEST(RandomTest, XoShiro256PlusX4MatchesScalarReference)
+{
+    // Reference xoshiro256+, one generator per lane, seeded from the same splitmix64 stream.
+    std::uint64_t seed = 99;
+    std::array<std::array<std::uint64_t, 4>, 4> lanes;
+    for (auto &state : lanes)
+    {
+        for (auto &word : state)
+        {
+            word = omp::splitmix64(seed);
+        }
+    }
+    omp::XoShiro256PlusX4 rng(99);
+    for (std::size_t block = 0; block < 64; ++block)
+    {
+        for (auto &s : lanes)
+        {
+            const std::uint64_t expected = s[0] + s[3];
+            const std::uint64_t t = s[1] << 17;
+            s[2] ^= s[0];
+            s[3] ^= s[1];
+            s[1] ^= s[2];
+            s[0] ^= s[3];
+            s[2] ^= t;
+            s[3] = std::rotl(s[3], 45);
+            EXPECT_EQ(rng(), expected);
+        }
+    }
+}
+
+TEST(RandomTest, XoShiro256PlusX4VectorPathMatchesConstantEvaluation)
+{
+    // Constant evaluation always steps the lanes with scalar code.
+    static constexpr Deck popped = []
+    {
+        Deck deck = Deck::createFullDeck();
+        omp::XoShiro256PlusX4 rng{2024};
+        for (int i = 0; i < 9; ++i)
+        {
+            deck.popPair(rng);
+        }
+        return deck.popRandomCards(rng, 5);
+    }();
+    Deck deck = Deck::createFullDeck();
+    omp::XoShiro256PlusX4 rng{2024};
+    for (int i = 0; i < 9; ++i)
+    {
+        deck.popPair(rng);
+    }
+    EXPECT_EQ(deck.popRandomCards(rng, 5), popped);
+    static_assert(popped.size() == 5);
+}
+
+TEST(RandomTest, XoShiro256PlusX4BulkFill)
+{
+    omp::XoShiro256PlusX4 single(7);
+    omp::XoShiro256PlusX4 bulk(7);
+    std::vector<std::uint64_t> values(103);
+    bulk.fill(values);
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+        EXPECT_EQ(values[i], single());
+    }
+
+    omp::XoShiro256PlusX4 reference(8);
+    omp::XoShiro256PlusX4 bounded(8);
+    std::vector<std::uint32_t> indices(37);
+    bounded.fillBounded(indices, 52);
+    for (std::size_t i = 0; i < indices.size(); i += 2)
+    {
+        const std::uint64_t value = reference();
+        EXPECT_EQ(indices[i], ((value & 0xFFFFFFFFull) * 52) >> 32);
+        if (i + 1 < indices.size())
+        {
+            EXPECT_EQ(indices[i + 1], ((value >> 32) * 52) >> 32);
+        }
+    }
+    EXPECT_TRUE(std::all_of(indices.begin(), indices.end(), [](std::uint32_t index)
+                            { return index < 52; }));
+}
+
 TEST(BugReproduction, StaticAssert_WheelStraightWithKickers)
 {
     // Bug: Wheel Straight (A-2-3-4-5) com Kickers
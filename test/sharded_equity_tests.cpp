@@ -0,0 +1,242 @@
+#include <gtest/gtest.h>
+#include <future>
+#include <thread>
+#include <vector>
+#include "../include/sharded_equity.hpp"
+
+static BS::thread_pool<BS::tp::none> shardPool(2);
+
+// Runs the coordinator on its own thread. finish() stops it if it has not returned within a
+// bounded time, so a broken requeue fails the test instead of hanging it.
+class TestCoordinator
+{
+private:
+    std::stop_source m_stop;
+    std::future<std::vector<std::uint64_t>> m_totals;
+
+public:
+    inline TestCoordinator(const ShardJob &job, const Socket &listener, std::chrono::milliseconds shardTimeout)
+        : m_totals(std::async(std::launch::async, [&job, &listener, shardTimeout, token = m_stop.get_token()]
+                              { return coordinateShards(job, listener, shardTimeout, token); })) {}
+    inline ~TestCoordinator() { m_stop.request_stop(); }
+    inline std::optional<std::vector<std::uint64_t>> finish(std::chrono::seconds limit = std::chrono::seconds(60))
+    {
+        if (m_totals.wait_for(limit) != std::future_status::ready)
+        {
+            m_stop.request_stop();
+            m_totals.wait();
+            return std::nullopt;
+        }
+        return m_totals.get();
+    }
+};
+
+static std::vector<std::uint64_t> runOnLocalhost(const ShardJob &job, std::size_t numWorkers)
+{
+    std::optional<Socket> listener = Socket::listen(0);
+    EXPECT_TRUE(listener.has_value());
+    const std::uint16_t port = listener->localPort();
+    TestCoordinator coordinator(job, *listener, std::chrono::seconds(30));
+    std::vector<std::jthread> workers;
+    for (std::size_t i = 0; i < numWorkers; ++i)
+    {
+        workers.emplace_back([port]
+                             {
+            BS::thread_pool<BS::tp::none> pool(1);
+            runShardWorker("127.0.0.1", port, pool); });
+    }
+    std::optional<std::vector<std::uint64_t>> totals = coordinator.finish();
+    EXPECT_TRUE(totals.has_value());
+    return totals.value_or(std::vector<std::uint64_t>{});
+}
+
+TEST(ShardedEquityTests, WorkersReproduceLocalShards)
+{
+    ShardJob job;
+    job.kind = ShardJobKind::Equity;
+    job.playerMask = Deck::parseHand("ah kd").getMask();
+    job.tableMask = Deck::parseHand("qs 7h 2c").getMask();
+    job.numPlayers = 4;
+    job.total = 50'000;
+    job.shardSize = 8'000;
+    job.seed = 42;
+    std::vector<std::uint64_t> totals = runOnLocalhost(job, 3);
+    ASSERT_EQ(totals.size(), 5u);
+    EXPECT_EQ(totals, computeAllShards(job, shardPool));
+    EXPECT_EQ(totals[0] + totals[1] + totals[2], 50'000u);
+}
+
+TEST(ShardedEquityTests, StartingHandShardsMergeExactly)
+{
+    ShardJob job;
+    job.kind = ShardJobKind::StartingHands;
+    job.tableMask = Deck::parseHand("as 7c 2d").getMask();
+    job.numPlayers = 3;
+    job.total = 300;
+    job.shardSize = 64;
+    job.seed = 7;
+    std::vector<std::uint64_t> totals = runOnLocalhost(job, 2);
+    EXPECT_EQ(totals, computeAllShards(job, shardPool));
+    EXPECT_EQ(totals.back(), 300u);
+}
+
+TEST(ShardedEquityTests, ExhaustiveShardsMatchDirectSweep)
+{
+    ShardJob job;
+    job.kind = ShardJobKind::PreflopMatrix;
+    job.total = 5;
+    job.shardSize = 2;
+    std::vector<std::uint64_t> totals = runOnLocalhost(job, 2);
+
+    const auto &boards = detail::sharedCanonicalBoards();
+    detail::PreflopPoints direct;
+    auto scratch = std::make_unique<detail::PreflopScratch>();
+    for (std::size_t i = 0; i < 5; ++i)
+    {
+        detail::accumulatePreflopBoard(boards[i].mask, boards[i].weight, direct, *scratch);
+    }
+    EXPECT_EQ(totals, direct.points);
+}
+
+TEST(ShardedEquityTests, LostWorkerShardIsRequeued)
+{
+    ShardJob job;
+    job.kind = ShardJobKind::Equity;
+    job.playerMask = Deck::parseHand("jh 6h").getMask();
+    job.numPlayers = 6;
+    job.total = 20'000;
+    job.shardSize = 5'000;
+    job.seed = 1234;
+    std::optional<Socket> listener = Socket::listen(0);
+    ASSERT_TRUE(listener.has_value());
+    const std::uint16_t port = listener->localPort();
+    TestCoordinator coordinator(job, *listener, std::chrono::seconds(30));
+    {
+        // Takes a shard and disconnects without answering.
+        std::optional<Socket> crashing = Socket::connect("127.0.0.1", port);
+        ASSERT_TRUE(crashing.has_value());
+        detail::ShardMessageHeader header;
+        ShardJob received;
+        ASSERT_TRUE(detail::receiveValue(*crashing, header));
+        ASSERT_TRUE(detail::receiveValue(*crashing, received));
+        EXPECT_EQ(header.type, detail::ShardMessageType::Assign);
+        EXPECT_EQ(received.seed, job.seed);
+    }
+    BS::thread_pool<BS::tp::none> pool(1);
+    std::future<std::size_t> completed = std::async(std::launch::async, [port, &pool]
+                                                    { return runShardWorker("127.0.0.1", port, pool); });
+    std::optional<std::vector<std::uint64_t>> totals = coordinator.finish();
+    ASSERT_TRUE(totals.has_value()) << "coordinator never got the dropped shard back";
+    EXPECT_EQ(completed.get(), 4u);
+    EXPECT_EQ(*totals, computeAllShards(job, shardPool));
+}
+
+TEST(ShardedEquityTests, HungWorkerShardIsRequeuedAfterTimeout)
+{
+    ShardJob job;
+    job.kind = ShardJobKind::Equity;
+    job.playerMask = Deck::parseHand("qc qd").getMask();
+    job.numPlayers = 3;
+    job.total = 12'000;
+    job.shardSize = 4'000;
+    job.seed = 99;
+    std::optional<Socket> listener = Socket::listen(0);
+    ASSERT_TRUE(listener.has_value());
+    const std::uint16_t port = listener->localPort();
+    TestCoordinator coordinator(job, *listener, std::chrono::milliseconds(300));
+
+    // Takes a shard and then goes silent with the connection still open.
+    std::optional<Socket> hung = Socket::connect("127.0.0.1", port);
+    ASSERT_TRUE(hung.has_value());
+    detail::ShardMessageHeader header;
+    ShardJob received;
+    ASSERT_TRUE(detail::receiveValue(*hung, header));
+    ASSERT_TRUE(detail::receiveValue(*hung, received));
+
+    BS::thread_pool<BS::tp::none> pool(1);
+    std::future<std::size_t> completed = std::async(std::launch::async, [port, &pool]
+                                                    { return runShardWorker("127.0.0.1", port, pool); });
+    std::optional<std::vector<std::uint64_t>> totals = coordinator.finish();
+    ASSERT_TRUE(totals.has_value()) << "coordinator kept waiting on the hung worker";
+    EXPECT_EQ(completed.get(), 3u);
+    EXPECT_EQ(*totals, computeAllShards(job, shardPool));
+    // The coordinator dropped the hung connection.
+    EXPECT_FALSE(detail::receiveValue(*hung, header, std::chrono::steady_clock::now() + std::chrono::seconds(5)));
+}
+
+TEST(ShardedEquityTests, WorkerRejectsUnsupportedTableSizes)
+{
+    ShardJob bad;
+    bad.kind = ShardJobKind::Equity;
+    bad.total = 1'000;
+    bad.shardSize = 1'000;
+    for (const std::uint32_t numPlayers : {0u, 1u, 11u, 40u})
+    {
+        bad.numPlayers = numPlayers;
+        EXPECT_FALSE(bad.valid()) << numPlayers;
+        std::optional<Socket> listener = Socket::listen(0);
+        ASSERT_TRUE(listener.has_value());
+        EXPECT_TRUE(coordinateShards(bad, *listener).empty());
+
+        // A coordinator that sends the job anyway gets the connection closed, not a result.
+        const std::uint16_t port = listener->localPort();
+        BS::thread_pool<BS::tp::none> pool(1);
+        std::future<std::size_t> completed = std::async(std::launch::async, [port, &pool]
+                                                        { return runShardWorker("127.0.0.1", port, pool); });
+        ASSERT_TRUE(listener->waitReadable(10'000));
+        std::optional<Socket> worker = listener->accept();
+        ASSERT_TRUE(worker.has_value());
+        detail::ShardMessageHeader header;
+        header.type = detail::ShardMessageType::Assign;
+        ASSERT_TRUE(detail::sendValue(*worker, header));
+        ASSERT_TRUE(detail::sendValue(*worker, bad));
+        EXPECT_FALSE(detail::receiveValue(*worker, header, std::chrono::steady_clock::now() + std::chrono::seconds(10))) << numPlayers;
+        worker->close();
+        EXPECT_EQ(completed.get(), 0u);
+    }
+}
+
+TEST(ShardedEquityTests, StopInterruptsWaitsOnSilentPeers)
+{
+    ShardJob job;
+    job.kind = ShardJobKind::Equity;
+    job.playerMask = Deck::parseHand("8s 8d").getMask();
+    job.numPlayers = 2;
+    job.total = 4'000;
+    job.shardSize = 4'000;
+    std::optional<Socket> listener = Socket::listen(0);
+    ASSERT_TRUE(listener.has_value());
+    const std::uint16_t port = listener->localPort();
+
+    // The coordinator waits on a worker that took the only shard and went silent; with the
+    // default 30-minute shard timeout only the stop token can end that wait.
+    std::stop_source stopCoordinator;
+    std::future<std::vector<std::uint64_t>> totals = std::async(std::launch::async, [&job, &listener, token = stopCoordinator.get_token()]
+                                                                { return coordinateShards(job, *listener, defaultShardTimeout, token); });
+    std::optional<Socket> hung = Socket::connect("127.0.0.1", port);
+    ASSERT_TRUE(hung.has_value());
+    detail::ShardMessageHeader header;
+    ShardJob received;
+    ASSERT_TRUE(detail::receiveValue(*hung, header));
+    ASSERT_TRUE(detail::receiveValue(*hung, received));
+    stopCoordinator.request_stop();
+    EXPECT_EQ(totals.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    hung->close();
+    EXPECT_TRUE(totals.get().empty());
+
+    // A worker waiting for its next assignment stops the same way.
+    std::optional<Socket> silent = Socket::listen(0);
+    ASSERT_TRUE(silent.has_value());
+    const std::uint16_t silentPort = silent->localPort();
+    std::stop_source stopWorker;
+    BS::thread_pool<BS::tp::none> pool(1);
+    std::future<std::size_t> completed = std::async(std::launch::async, [silentPort, &pool, token = stopWorker.get_token()]
+                                                    { return runShardWorker("127.0.0.1", silentPort, pool, token); });
+    ASSERT_TRUE(silent->waitReadable(10'000));
+    std::optional<Socket> connection = silent->accept();
+    ASSERT_TRUE(connection.has_value());
+    stopWorker.request_stop();
+    EXPECT_EQ(completed.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    connection->close();
+    EXPECT_EQ(completed.get(), 0u);
+}